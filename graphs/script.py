@@ -1,15 +1,28 @@
 import numpy as np
 import matplotlib.pyplot as pl
 
-data = np.genfromtxt('../res/spikes.gdf')
+# Binary spike file written by the network (see src/spike_recorder.hpp):
+# a 24 bytes header, then one (step, neuron) record of two little-endian uint32 per spike
+header_type = np.dtype([('magic', 'S4'), ('version', '<u4'), ('nbNeurons', '<u4'), ('reserved', '<u4'), ('dt', '<f8')])
+record_type = np.dtype([('step', '<u4'), ('neuron', '<u4')])
 
-select= np.array([d for d in data if d[1] < 50])
-data1= select.transpose()
+def load_spikes(path):
+	with open(path, 'rb') as f:
+		header = np.fromfile(f, dtype=header_type, count=1)[0]
+		if header['magic'] != b'SPKB' or header['version'] != 1:
+			raise ValueError(path + " is not a spike file")
+		records = np.fromfile(f, dtype=record_type)
+	return header, records
+
+header, data = load_spikes('../res/spikes.bin')
+dt = header['dt']
+
+select = data[data['neuron'] < 50]
 
 pl.Figure(figsize = (30,30))
 
 pl.subplot(211)
-pl.scatter(0.1*data1[0],data1[1],alpha=0.8, edgecolors='none');
+pl.scatter(dt*select['step'],select['neuron'],alpha=0.8, edgecolors='none');
 
 pl.title("Neural network simulation")
 pl.xlabel("Time [ms]")
@@ -21,8 +34,10 @@ axes.set_ylim([0,50])
 
 
 pl.subplot(212)
-data2 = data.transpose()
-n, bins, patches = pl.hist(0.1*data2[0], 12000, normed=0, alpha=0.75)
+# Spikes counted in bins of time by the network (see src/rate_recorder.hpp)
+rates = np.genfromtxt('../res/rates.csv', delimiter=',', names=True)
+width = rates['time'][1] - rates['time'][0] if len(rates) > 1 else dt
+pl.bar(rates['time'], rates['excitatory'] + rates['inhibitory'], width=width, align='edge', alpha=0.75)
 
 pl.xlabel("Time [ms]")
 pl.ylabel("Number of spikes")
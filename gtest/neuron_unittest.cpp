@@ -1,6 +1,31 @@
 #include <iostream>
 #include "../src/neuron.hpp"
 #include "../src/network.hpp"
+#include "../src/poisson.hpp"
+#include "../src/kernel.hpp"
+#include "../src/spike_recorder.hpp"
+#include "../src/async_recorder.hpp"
+#include "../src/spike_selection.hpp"
+#include "../src/spike_store.hpp"
+#include "../src/spike_codec.hpp"
+#include "../src/sweep.hpp"
+#include "../src/snapshot.hpp"
+#include "../src/parameters.hpp"
+#include "../src/scaling.hpp"
+#include "../src/profiler.hpp"
+#include "../src/perf_counters.hpp"
+#include "../src/memory_report.hpp"
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "gtest/gtest.h"
 
 TEST (NeuronTest1, MembranePotential) {
@@ -28,7 +53,7 @@ TEST (NeuronTest2, PositiveInput) {
 	}
 	
 	
-	EXPECT_EQ(0,neuron.getNbSpikes());
+	EXPECT_EQ(0u,neuron.getNbSpikes());
 	EXPECT_GT(1E-3, std::fabs(19.999 - neuron.getPotential()));
 	
 	neuron.setIext(0.0);
@@ -58,7 +83,7 @@ TEST (NeuronTest3, NegativeInput) {
 		++i;
 	}
 	
-	EXPECT_EQ(0,neuron.getNbSpikes());
+	EXPECT_EQ(0u,neuron.getNbSpikes());
 	EXPECT_GT(-20.0*1.0*(1-std::exp(-0.1/20.0)), neuron.getPotential());
 	
 	neuron.setIext(0.0);
@@ -84,7 +109,7 @@ TEST (NeuronTest5, oneNeuronSimulationSpikes) {
 		++j;
 	}
 	
-	EXPECT_EQ(4, neuron.getNbSpikes());
+	EXPECT_EQ(4u, neuron.getNbSpikes());
 }
 
 TEST (TwoNeuronsTest1, SpikeArrivalTime) {	
@@ -103,10 +128,10 @@ TEST (TwoNeuronsTest1, SpikeArrivalTime) {
 	network.update();
 
 	//just before neuron2 spike
-	EXPECT_EQ(1, neuron1.getNbSpikes());
+	EXPECT_EQ(1u, neuron1.getNbSpikes());
 	EXPECT_EQ(0.0, neuron2.getPotential());
 	neuron2.update(network.getReadBox());
-	EXPECT_EQ(0, neuron2.getNbSpikes());
+	EXPECT_EQ(0u, neuron2.getNbSpikes());
 	EXPECT_EQ(0.1, neuron2.getPotential());
 
 }
@@ -127,10 +152,10 @@ TEST (TwoNeuronsTest2, InhibitatoryConnection_Delay) {
 	network.update();
 
 	//just before neuron2 spike
-	EXPECT_EQ(1, neuron1.getNbSpikes());
+	EXPECT_EQ(1u, neuron1.getNbSpikes());
 	EXPECT_EQ(0.0, neuron2.getPotential());
 	neuron2.update(network.getReadBox());
-	EXPECT_EQ(0, neuron2.getNbSpikes());
+	EXPECT_EQ(0u, neuron2.getNbSpikes());
 	EXPECT_EQ(-g*0.1, neuron2.getPotential());
 
 }
@@ -150,10 +175,10 @@ TEST (TwoNeuronsTest3, ExcitatoryConnection_Delay) {
 	network.update();
 
 	//just before neuron2 spike
-	EXPECT_EQ(1, neuron1.getNbSpikes());
+	EXPECT_EQ(1u, neuron1.getNbSpikes());
 	EXPECT_EQ(0.0, neuron2.getPotential());
 	neuron2.update(network.getReadBox());
-	EXPECT_EQ(0, neuron2.getNbSpikes());
+	EXPECT_EQ(0u, neuron2.getNbSpikes());
 	EXPECT_EQ(0.1, neuron2.getPotential());
 
 }
@@ -178,8 +203,8 @@ TEST (NetworkTest1, typeDefinition) {
 		} else { ++nbExcitatory; }
 	}
 	
-	EXPECT_EQ(20, nbInhibitory);
-	EXPECT_EQ(80, nbExcitatory);
+	EXPECT_EQ(20u, nbInhibitory);
+	EXPECT_EQ(80u, nbExcitatory);
 }
 
 TEST (NetworkTest2, connections) {
@@ -194,10 +219,1201 @@ TEST (NetworkTest2, connections) {
 	
 	Network network(1, neurons);
 	
-	EXPECT_EQ(20, network.getNbInhibitoryConnections());
-	EXPECT_EQ(80, network.getNbExcitatoryConnections());
+	EXPECT_EQ(20u, network.getNbInhibitoryConnections());
+	EXPECT_EQ(80u, network.getNbExcitatoryConnections());
+	EXPECT_EQ(1000*100u, network.getNbConnections());
+	
+	// Each neuron receives 20 inhibitory and 80 excitatory connections
+	std::vector<unsigned int> nbInhibitory(1000, 0);
+	std::vector<unsigned int> nbExcitatory(1000, 0);
+	size_t nbConnections(0);
+	
+	for (unsigned int source(0); source < 1000; ++source) {
+		const unsigned int* targets = network.getTargets(source);
+		for (unsigned int k(0); k < network.getNbTargets(source); ++k) {
+			if (network.getPopulation().isInhibiter(source)) {
+				++nbInhibitory[targets[k]];
+			} else { ++nbExcitatory[targets[k]]; }
+			
+			if (k > 0) {
+				EXPECT_LE(targets[k-1], targets[k]);
+			}
+		}
+		nbConnections += network.getNbTargets(source);
+	}
+	
+	EXPECT_EQ(network.getNbConnections(), nbConnections);
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(20u, nbInhibitory[i]);
+		EXPECT_EQ(80u, nbExcitatory[i]);
+	}
 }	
 
+TEST (NetworkTest3, proceduralConnections) {
+	
+	Network network(1, 1000, Connectivity::Procedural);
+	EXPECT_EQ(Connectivity::Procedural, network.getConnectivity());
+	EXPECT_EQ(1000*100u, network.getNbConnections());
+	
+	std::vector<unsigned int> nbInhibitory(1000, 0);
+	std::vector<unsigned int> nbExcitatory(1000, 0);
+	std::vector<unsigned int> targets, again, firstPart, secondPart;
+	
+	for (unsigned int source(0); source < 1000; ++source) {
+		network.drawTargets(source, 0, 1000, targets);
+		EXPECT_EQ(network.getNbTargets(source), targets.size());
+		
+		// the same targets are drawn each time, whatever the partition of the targets
+		network.drawTargets(source, 0, 1000, again);
+		network.drawTargets(source, 0, 512, firstPart);
+		network.drawTargets(source, 512, 1000, secondPart);
+		firstPart.insert(firstPart.end(), secondPart.begin(), secondPart.end());
+		EXPECT_EQ(targets, again);
+		EXPECT_EQ(targets, firstPart);
+		
+		for (auto target : targets) {
+			if (network.getPopulation().isInhibiter(source)) {
+				++nbInhibitory[target];
+			} else { ++nbExcitatory[target]; }
+		}
+	}
+	
+	// In average, each neuron receives 20 inhibitory and 80 excitatory connections
+	double meanInhibitory(0.0), meanExcitatory(0.0);
+	for (unsigned int i(0); i < 1000; ++i) {
+		meanInhibitory += nbInhibitory[i]/1000.0;
+		meanExcitatory += nbExcitatory[i]/1000.0;
+	}
+	EXPECT_NEAR(20, meanInhibitory, 1e-9);
+	EXPECT_NEAR(80, meanExcitatory, 1e-9);
+}
+
+TEST (PopulationTest1, neuronView) {
+	Neuron neuron1(1,1.01);
+	Neuron neuron2(1);
+	neuron2.setIsInhibiter(true);
+	unsigned int readBox(0);
+	
+	{
+		std::vector<Neuron*> neurons = { &neuron1, &neuron2};
+		Network network(92.4 + Delay, neurons);
+		
+		//the neurons are views on the population of the network
+		EXPECT_TRUE(network.getPopulation().isInhibiter(1));
+		EXPECT_EQ(1.01, network.getPopulation().getIext(0));
+		
+		network.update();
+		EXPECT_EQ(1u, network.getPopulation().getNbSpikes(0));
+		EXPECT_EQ(neuron1.getPotential(), network.getPopulation().getPotential(0));
+		readBox = network.getReadBox();
+	}
+	
+	//once the network is destroyed, the neurons keep their state
+	EXPECT_EQ(1u, neuron1.getNbSpikes());
+	EXPECT_TRUE(neuron2.isInhibiter());
+	EXPECT_EQ(1.0, neuron2.getBuffer(readBox));
+}
+
+TEST (ThreadTest1, sameAsSerial) {
+	
+	// The seed is the same for both networks: connections and external spikes are identical
+	Network serial(50, 1000);
+	Network parallel(50, 1000);
+	parallel.setNbThreads(3);
+	
+	EXPECT_EQ(3u, parallel.getNbThreads());
+	EXPECT_EQ(0u, parallel.getPartitionBegin(0) % 64);
+	EXPECT_EQ(0u, parallel.getPartitionBegin(1) % 64);
+	EXPECT_EQ(1000u, parallel.getPartitionBegin(3));
+	
+	serial.update();
+	parallel.update();
+	
+	unsigned int nbSpikes(0);
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(serial.getPopulation().getNbSpikes(i), parallel.getPopulation().getNbSpikes(i));
+		EXPECT_EQ(serial.getPopulation().getPotential(i), parallel.getPopulation().getPotential(i));
+		nbSpikes += serial.getPopulation().getNbSpikes(i);
+	}
+	EXPECT_LT(0u, nbSpikes);
+}
+
+TEST (ThreadTest2, parallelTransmission) {
+	
+	Network serial(20, 2000);
+	Network parallel(20, 2000);
+	parallel.setNbThreads(4);
+	
+	serial.update();
+	parallel.update();
+	
+	// every spike transmitted by the threads is found in the time buffer of its target
+	for (unsigned int slot(0); slot <= DelayStep; ++slot) {
+		for (unsigned int i(0); i < 2000; ++i) {
+			EXPECT_EQ(serial.getPopulation().getBuffer(i, slot), parallel.getPopulation().getBuffer(i, slot));
+		}
+	}
+}
+
+TEST (RandomTest1, poissonDistribution) {
+	
+	Network network(1, 100);
+	
+	// mean and variance of the external spikes are both dt*Vext
+	double mean(0.0), square(0.0);
+	unsigned int n(0);
+	for (unsigned int i(0); i < 100; ++i) {
+		for (unsigned long step(0); step < 1000; ++step) {
+			double k = network.poisson(i, step);
+			mean += k;
+			square += k*k;
+			++n;
+		}
+	}
+	mean /= n;
+	EXPECT_NEAR(dt*Vext, mean, 0.02);
+	EXPECT_NEAR(dt*Vext, square/n - mean*mean, 0.05);
+	
+	// the external spikes of a step do not depend on the previous steps
+	EXPECT_EQ(network.poisson(42, 123456789012UL), network.poisson(42, 123456789012UL));
+}
+
+TEST (RandomTest2, seed) {
+	
+	Network first(10, 1000);
+	Network second(10, 1000);
+	EXPECT_EQ(first.getSeed(), second.getSeed());
+	
+	second.setSeed(7);
+	EXPECT_EQ(7u, second.getSeed());
+	
+	// another seed gives other connections
+	unsigned int nbDifferences(0);
+	for (unsigned int source(0); source < 1000; ++source) {
+		if (first.getNbTargets(source) != second.getNbTargets(source)) {
+			++nbDifferences;
+		}
+	}
+	EXPECT_LT(0u, nbDifferences);
+	
+	// the same seed gives the same simulation
+	first.setSeed(7);
+	first.update();
+	second.update();
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(first.getPopulation().getPotential(i), second.getPopulation().getPotential(i));
+	}
+}
+
+TEST (RandomTest3, bulkPoisson) {
+	
+	PoissonGenerator poisson(dt*Vext);
+	Philox::Key key = Philox::key(12);
+	
+	// drawn in bulk for 1000 neurons, step by step or for a window of steps
+	std::vector<double> slot(1000, 0.0);
+	std::vector<std::vector<double> > window(DelayStep, std::vector<double>(1000, 0.0));
+	std::vector<double*> slots;
+	for (auto& s : window) {
+		slots.push_back(s.data());
+	}
+	poisson.fill(key, 3, 50, 0, 1000, slot.data());
+	poisson.fill(key, 3, 50, DelayStep, 0, 1000, slots.data());
+	
+	// the same spikes as drawn one by one
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(poisson.draw(key, 3, i, 50), slot[i]);
+		for (unsigned int s(0); s < DelayStep; ++s) {
+			EXPECT_EQ(poisson.draw(key, 3, i, 50 + s), window[s][i]);
+		}
+	}
+	
+	EXPECT_EQ(0u, poisson.draw(0));
+	EXPECT_LT(10u, poisson.draw(0xFFFFFFFF));
+}
+
+TEST (KernelTest1, sameAsScalar) {
+	
+	// refractory, spiking and integrating neurons (1003 neurons: the last ones are updated by the scalar tail)
+	const unsigned int n(1003);
+	std::vector<double> potential(n), iext(n), input(n);
+	std::vector<int> refractory(n);
+	for (unsigned int i(0); i < n; ++i) {
+		potential[i] = (i*7919 % 300)/10.0 - 5.0;
+		refractory[i] = (i % 5 == 0) ? i % 20 : 0;
+		iext[i] = (i % 3)*0.5;
+		input[i] = static_cast<double>(i % 11) - 5.0;
+	}
+	
+	std::vector<double> scalarPotential(potential);
+	std::vector<int> scalarRefractory(refractory);
+	std::vector<uint64_t> scalarSpike((n+63)/64, ~uint64_t(0));
+	std::vector<unsigned int> scalarNbSpikes(n, 0);
+	MembraneArrays scalar = { scalarPotential.data(), scalarRefractory.data(), iext.data(), input.data(), scalarSpike.data(), scalarNbSpikes.data() };
+	getMembraneKernel(Kernel::Scalar)(scalar, getDefaultConstants(), 0, n);
+	
+	for (Kernel kernel : { Kernel::SSE2, Kernel::AVX2, Kernel::AVX512 }) {
+		if (!isSupported(kernel)) {
+			continue;
+		}
+		std::vector<double> vectorPotential(potential);
+		std::vector<int> vectorRefractory(refractory);
+		std::vector<uint64_t> vectorSpike((n+63)/64, ~uint64_t(0));
+		std::vector<unsigned int> vectorNbSpikes(n, 0);
+		MembraneArrays arrays = { vectorPotential.data(), vectorRefractory.data(), iext.data(), input.data(), vectorSpike.data(), vectorNbSpikes.data() };
+		getMembraneKernel(kernel)(arrays, getDefaultConstants(), 0, n);
+		
+		EXPECT_EQ(scalarPotential, vectorPotential) << getName(kernel);
+		EXPECT_EQ(scalarRefractory, vectorRefractory) << getName(kernel);
+		EXPECT_EQ(scalarSpike, vectorSpike) << getName(kernel);
+		EXPECT_EQ(scalarNbSpikes, vectorNbSpikes) << getName(kernel);
+	}
+}
+
+TEST (KernelTest2, networkSimulation) {
+	
+	Network scalar(30, 1000);
+	scalar.setKernel(Kernel::Scalar);
+	scalar.update();
+	
+	Network best(30, 1000);
+	best.setKernel(bestKernel());
+	best.update();
+	
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(scalar.getPopulation().getPotential(i), best.getPopulation().getPotential(i));
+		EXPECT_EQ(scalar.getPopulation().getNbSpikes(i), best.getPopulation().getNbSpikes(i));
+	}
+}
+
+TEST (KernelTest3, spikeList) {
+	
+	NeuronPopulation population(1000);
+	for (unsigned int i : { 3u, 64u, 65u, 500u, 999u }) {
+		population.setPotential(i, Threshold + 1.0);
+	}
+	population.update(0, 1000, 0);
+	
+	// the spike mask is compacted into the list of the spiking neurons
+	std::vector<unsigned int> spikes;
+	population.collectSpikes(0, 1000, spikes);
+	EXPECT_EQ(std::vector<unsigned int>({ 3, 64, 65, 500, 999 }), spikes);
+	EXPECT_TRUE(population.hasSpike(64));
+	EXPECT_FALSE(population.hasSpike(66));
+	
+	spikes.clear();
+	population.collectSpikes(64, 512, spikes);
+	EXPECT_EQ(std::vector<unsigned int>({ 64, 65, 500 }), spikes);
+	
+	// at the next step, the neurons are refractory
+	population.update(0, 1000, 0);
+	spikes.clear();
+	population.collectSpikes(0, 1000, spikes);
+	EXPECT_TRUE(spikes.empty());
+}
+
+TEST (WindowTest1, sameAsStep) {
+	
+	for (Connectivity connectivity : { Connectivity::Stored, Connectivity::Procedural }) {
+		// exchange of the spikes at each step
+		Network step(50, 2500, connectivity);
+		step.setWindowSteps(1);
+		
+		// exchange of the spikes every DelayStep steps: 500 steps end with a partial window
+		Network window(50, 2500, connectivity);
+		window.setNbThreads(2);
+		EXPECT_EQ(DelayStep, window.getWindowSteps());
+		
+		step.update();
+		window.update();
+		
+		EXPECT_EQ(step.getReadBox(), window.getReadBox());
+		for (unsigned int i(0); i < 2500; ++i) {
+			EXPECT_EQ(step.getPopulation().getPotential(i), window.getPopulation().getPotential(i));
+			EXPECT_EQ(step.getPopulation().getNbSpikes(i), window.getPopulation().getNbSpikes(i));
+			for (unsigned int slot(0); slot <= DelayStep; ++slot) {
+				EXPECT_EQ(step.getPopulation().getBuffer(i, slot), window.getPopulation().getBuffer(i, slot));
+			}
+		}
+	}
+}
+
+TEST (RecorderTest1, binarySpikeFile) {
+	
+	// more records than a block: the file is written in several blocks
+	unsigned long nbRecords = SpikeRecorder::BlockRecords + 100;
+	{
+		SpikeRecorder recorder;
+		EXPECT_TRUE(recorder.open("recorder_test.bin", 1000, dt));
+		for (unsigned long k(0); k < nbRecords; ++k) {
+			recorder.record(k/7, k % 1000);
+		}
+		EXPECT_EQ(nbRecords, recorder.getNbRecords());
+	}
+	
+	SpikeReader reader("recorder_test.bin");
+	ASSERT_TRUE(reader.isValid());
+	EXPECT_EQ(1000u, reader.getHeader().nbNeurons);
+	EXPECT_EQ(dt, reader.getHeader().dt);
+	
+	std::vector<SpikeRecord> records = reader.readAll();
+	ASSERT_EQ(nbRecords, records.size());
+	for (unsigned long k(0); k < nbRecords; ++k) {
+		EXPECT_EQ(k/7, records[k].step);
+		EXPECT_EQ(k % 1000, records[k].neuron);
+	}
+	std::remove("recorder_test.bin");
+	
+	// the spikes of a simulation are all found in the spike file at its end
+	Network network(30, 1000);
+	network.update();
+	
+	std::vector<unsigned int> nbSpikes(1000, 0);
+	for (auto record : SpikeReader("../res/spikes.bin").readAll()) {
+		ASSERT_LT(record.neuron, 1000u);
+		++nbSpikes[record.neuron];
+	}
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(network.getPopulation().getNbSpikes(i), nbSpikes[i]);
+	}
+}
+
+TEST (RecorderTest2, asyncRecorder) {
+	
+	// hand over through the lock-free ring, in order
+	SpscRing<int> ring(2);
+	EXPECT_TRUE(ring.push(1));
+	EXPECT_TRUE(ring.push(2));
+	EXPECT_FALSE(ring.push(3));
+	int value;
+	EXPECT_TRUE(ring.pop(value));
+	EXPECT_EQ(1, value);
+	EXPECT_TRUE(ring.pop(value));
+	EXPECT_EQ(2, value);
+	EXPECT_FALSE(ring.pop(value));
+	EXPECT_TRUE(ring.empty());
+	
+	// every record is written when the recorder is destroyed
+	unsigned long nbRecords = 3*SpikeRecorder::BlockRecords + 10;
+	{
+		AsyncRecorder recorder(2);
+		EXPECT_TRUE(recorder.open("recorder_test.bin", "recorder_test.txt", 1000, dt));
+		for (unsigned long k(0); k < nbRecords; ++k) {
+			recorder.recordSpikes(k/5, std::vector<unsigned int>(1, k % 1000));
+		}
+		for (unsigned long step(0); step < 100; ++step) {
+			recorder.recordTotal(step, 5);
+		}
+	}
+	
+	std::vector<SpikeRecord> records = SpikeReader("recorder_test.bin").readAll();
+	ASSERT_EQ(nbRecords, records.size());
+	for (unsigned long k(0); k < nbRecords; ++k) {
+		EXPECT_EQ(k/5, records[k].step);
+		EXPECT_EQ(k % 1000, records[k].neuron);
+	}
+	
+	std::ifstream totals("recorder_test.txt");
+	std::string line, lastLine;
+	unsigned int nbLines(0);
+	while (std::getline(totals, line)) {
+		lastLine = line;
+		++nbLines;
+	}
+	EXPECT_EQ(101u, nbLines);
+	EXPECT_EQ("9.9 5", lastLine);
+	
+	// the blocks written by the writer are in the file after a flush, before the file is closed
+	{
+		AsyncRecorder recorder(2);
+		ASSERT_TRUE(recorder.open("recorder_test.bin", "recorder_test.txt", 1000, dt));
+		for (unsigned long k(0); k < SpikeRecorder::BlockRecords + 10; ++k) {
+			recorder.recordSpikes(k, std::vector<unsigned int>(1, 0));
+		}
+		recorder.flush();
+		EXPECT_EQ(SpikeRecorder::BlockRecords + 10, SpikeReader("recorder_test.bin").readAll().size());
+	}
+	
+	// without its files the recorder stays closed
+	AsyncRecorder closed;
+	EXPECT_FALSE(closed.open("no_directory/recorder_test.bin", "recorder_test.txt", 1000, dt));
+	EXPECT_FALSE(closed.isOpen());
+	closed.recordSpikes(0, std::vector<unsigned int>(1, 0));
+	closed.flush();
+	
+	std::remove("recorder_test.bin");
+	std::remove("recorder_test.txt");
+}
+
+TEST (RecorderTest3, dropBackpressure) {
+	
+	// a ring of one block: the blocks that do not fit are dropped and counted, the simulation never waits
+	unsigned long nbRecords = 10*SpikeRecorder::BlockRecords;
+	AsyncRecorder recorder(1);
+	recorder.setBackpressure(Backpressure::Drop);
+	EXPECT_TRUE(recorder.open("recorder_test.bin", "recorder_test.txt", 1000, dt));
+	for (unsigned long k(0); k < nbRecords; ++k) {
+		recorder.recordSpikes(k, std::vector<unsigned int>(1, 0));
+	}
+	recorder.flush();
+	
+	// each spike is either written or counted as dropped
+	std::vector<SpikeRecord> records = SpikeReader("recorder_test.bin").readAll();
+	EXPECT_EQ(nbRecords, records.size() + recorder.getNbDroppedSpikes());
+	EXPECT_EQ(recorder.getNbDroppedSpikes(), recorder.getNbDroppedBlocks()*SpikeRecorder::BlockRecords);
+	
+	recorder.close();
+	std::remove("recorder_test.bin");
+	std::remove("recorder_test.txt");
+}
+
+TEST (RateTest1, populationRates) {
+	
+	// one bin per step
+	Network network(30, 1000);
+	network.update();
+	
+	const RateRecorder& rates = network.getRates();
+	EXPECT_EQ(300u, rates.getNbBins());
+	
+	unsigned int nbExcitatory(0), nbInhibitory(0);
+	for (size_t bin(0); bin < rates.getNbBins(); ++bin) {
+		nbExcitatory += rates.getNbExcitatorySpikes(bin);
+		nbInhibitory += rates.getNbInhibitorySpikes(bin);
+	}
+	
+	unsigned int nbSpikesExcitatory(0), nbSpikesInhibitory(0);
+	for (unsigned int i(0); i < 1000; ++i) {
+		if (network.getPopulation().isInhibiter(i)) {
+			nbSpikesInhibitory += network.getPopulation().getNbSpikes(i);
+		} else {
+			nbSpikesExcitatory += network.getPopulation().getNbSpikes(i);
+		}
+	}
+	EXPECT_EQ(nbSpikesExcitatory, nbExcitatory);
+	EXPECT_EQ(nbSpikesInhibitory, nbInhibitory);
+	EXPECT_LT(0u, nbExcitatory);
+	EXPECT_LT(0u, nbInhibitory);
+	
+	// bins of 1 ms in the window [10, 20): the same simulation gives the sums of 10 steps
+	Network binned(30, 1000);
+	binned.setRates(RateRecorder(1.0, 10.0, 20.0, dt));
+	binned.update();
+	
+	ASSERT_EQ(10u, binned.getRates().getNbBins());
+	for (size_t bin(0); bin < 10; ++bin) {
+		EXPECT_NEAR(10.0 + bin, binned.getRates().getTime(bin), 1e-9);
+		
+		unsigned int sumExcitatory(0), sumInhibitory(0);
+		for (size_t step(100 + 10*bin); step < 110 + 10*bin; ++step) {
+			sumExcitatory += rates.getNbExcitatorySpikes(step);
+			sumInhibitory += rates.getNbInhibitorySpikes(step);
+		}
+		EXPECT_EQ(sumExcitatory, binned.getRates().getNbExcitatorySpikes(bin));
+		EXPECT_EQ(sumInhibitory, binned.getRates().getNbInhibitorySpikes(bin));
+	}
+	
+	// a window starting before 0 starts at 0
+	EXPECT_EQ(0.0, RateRecorder(1.0, -5.0, 20.0, dt).getStart());
+	Network early(30, 1000);
+	early.setRates(RateRecorder(1.0, -5.0, 20.0, dt));
+	early.update();
+	ASSERT_EQ(20u, early.getRates().getNbBins());
+	EXPECT_EQ(binned.getRates().getNbExcitatorySpikes(0), early.getRates().getNbExcitatorySpikes(10));
+}
+
+TEST (SelectionTest1, selectedSpikes) {
+	
+	SpikeSelection list;
+	list.setNeurons({ 7, 3, 500 });
+	EXPECT_TRUE(list.isSelected(3));
+	EXPECT_FALSE(list.isSelected(4));
+	std::vector<unsigned int> selected;
+	list.select(0, { 1, 3, 4, 500, 501 }, selected);
+	EXPECT_EQ(std::vector<unsigned int>({ 3, 500 }), selected);
+	
+	// every spike of the simulation
+	std::vector<SpikeRecord> all;
+	{
+		Network network(30, 1000);
+		network.update();
+		all = SpikeReader("../res/spikes.bin").readAll();
+	}
+	
+	// one neuron out of 3 of [100, 400), during [10, 20)
+	SpikeSelection selection;
+	selection.setNeurons(100, 400, 3);
+	selection.setTime(10.0, 20.0, dt);
+	EXPECT_FALSE(selection.selectsAll());
+	
+	std::vector<SpikeRecord> expected;
+	for (auto record : all) {
+		if (record.step >= 100 and record.step < 200 and selection.isSelected(record.neuron)) {
+			EXPECT_EQ(0u, (record.neuron - 100) % 3);
+			expected.push_back(record);
+		}
+	}
+	EXPECT_LT(0u, expected.size());
+	
+	Network network(30, 1000);
+	network.setSpikeSelection(selection);
+	network.update();
+	std::vector<SpikeRecord> records = SpikeReader("../res/spikes.bin").readAll();
+	
+	ASSERT_EQ(expected.size(), records.size());
+	for (size_t k(0); k < records.size(); ++k) {
+		EXPECT_EQ(expected[k].step, records[k].step);
+		EXPECT_EQ(expected[k].neuron, records[k].neuron);
+	}
+	
+	// a window starting before 0 starts at 0, a window ending before 0 records nothing
+	SpikeSelection early;
+	early.setTime(-5.0, 2.0, dt);
+	EXPECT_TRUE(early.isRecorded(0));
+	EXPECT_TRUE(early.isRecorded(19));
+	EXPECT_FALSE(early.isRecorded(20));
+	early.setTime(-5.0, -1.0, dt);
+	EXPECT_FALSE(early.isRecorded(0));
+}
+
+TEST (StoreTest1, rangeQueries) {
+	
+	// chunks of 1 ms
+	{
+		Network network(50, 1000);
+		EXPECT_TRUE(network.openSpikeStore("store_test.store", 1.0));
+		network.update();
+	}
+	std::vector<SpikeRecord> all = SpikeReader("../res/spikes.bin").readAll();
+	
+	SpikeStore store("store_test.store");
+	ASSERT_TRUE(store.isValid());
+	EXPECT_EQ(all.size(), store.getHeader().nbRecords);
+	EXPECT_EQ(10u, store.getHeader().chunkSteps);
+	
+	// the queries give the same spikes as a scan of the whole spike file
+	struct Range { unsigned int firstNeuron, lastNeuron; double start, stop; };
+	for (Range range : { Range({ 0, 1000, 0.0, 50.0 }), Range({ 100, 150, 12.35, 31.0 }), Range({ 999, 1000, 0.0, 50.0 }), Range({ 0, 50, 49.9, 60.0 }) }) {
+		std::vector<SpikeRecord> expected;
+		for (auto record : all) {
+			if (record.neuron >= range.firstNeuron and record.neuron < range.lastNeuron
+			    and record.step >= std::lround(range.start/dt) and record.step < std::lround(range.stop/dt)) {
+				expected.push_back(record);
+			}
+		}
+		
+		std::vector<SpikeRecord> spikes = store.query(range.firstNeuron, range.lastNeuron, range.start, range.stop);
+		ASSERT_EQ(expected.size(), spikes.size());
+		for (size_t k(0); k < spikes.size(); ++k) {
+			EXPECT_EQ(expected[k].step, spikes[k].step);
+			EXPECT_EQ(expected[k].neuron, spikes[k].neuron);
+		}
+	}
+	
+	// a chunk whose records go past the index is rejected with the file
+	{
+		std::ifstream in("store_test.store", std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		SpikeChunk chunk;
+		memcpy(&chunk, bytes.data() + store.getHeader().indexOffset, sizeof(chunk));
+		chunk.nbRecords = all.size() + 1;
+		memcpy(bytes.data() + store.getHeader().indexOffset, &chunk, sizeof(chunk));
+		std::ofstream("store_corrupt.store", std::ios::binary).write(bytes.data(), bytes.size());
+	}
+	EXPECT_FALSE(SpikeStore("store_corrupt.store").isValid());
+	std::remove("store_corrupt.store");
+	std::remove("store_test.store");
+}
+
+TEST (CodecTest1, compressedSpikes) {
+	
+	// steps far apart, several spikes of the same neuron, large neurons and a step with more spikes than a block
+	const uint32_t nbNeurons(4000000001u);
+	std::vector<SpikeRecord> spikes = { { 3, 0 }, { 3, 0 }, { 3, 12499 }, { 4, 7 }, { 100000, 5 }, { 100000, 6 }, { 4000000000u, 4000000000u } };
+	for (uint32_t neuron(0); neuron < SpikeArchiveWriter::BlockRecords + 10; ++neuron) {
+		spikes.push_back({ 4000000001u, 3*neuron });
+	}
+	
+	std::vector<uint8_t> encoded;
+	SpikeCodec::encode(spikes.data(), spikes.size(), 3, nbNeurons, encoded);
+	std::vector<SpikeRecord> decoded(spikes.size());
+	EXPECT_TRUE(SpikeCodec::decode(encoded.data(), encoded.size(), 3, nbNeurons, decoded.size(), decoded.data()));
+	for (size_t k(0); k < spikes.size(); ++k) {
+		EXPECT_EQ(spikes[k].step, decoded[k].step);
+		EXPECT_EQ(spikes[k].neuron, decoded[k].neuron);
+	}
+	
+	// the archive of a simulation gives back the spikes of the spike file
+	{
+		Network network(50, 1000);
+		EXPECT_TRUE(network.openSpikeArchive("codec_test.spkz"));
+		network.update();
+	}
+	std::vector<SpikeRecord> all = SpikeReader("../res/spikes.bin").readAll();
+	{
+		SpikeArchive archive("codec_test.spkz");
+		ASSERT_TRUE(archive.isValid());
+		decoded = archive.decodeAll();
+		ASSERT_EQ(all.size(), decoded.size());
+		for (size_t k(0); k < all.size(); ++k) {
+			EXPECT_EQ(all[k].step, decoded[k].step);
+			EXPECT_EQ(all[k].neuron, decoded[k].neuron);
+		}
+	}
+	
+	// the archive of 12500 neurons is at least 5 times smaller than the records of the binary spike file
+	{
+		Network network(50, 12500, Connectivity::Procedural);
+		EXPECT_TRUE(network.openSpikeArchive("codec_test.spkz"));
+		network.update();
+	}
+	size_t nbRecords = SpikeReader("../res/spikes.bin").readAll().size();
+	std::ifstream compressed("codec_test.spkz", std::ios::binary | std::ios::ate);
+	EXPECT_GT(nbRecords*sizeof(SpikeRecord), 5*static_cast<size_t>(compressed.tellg()));
+	
+	// a sparse regime of 3 random neurons per step stays 4 times smaller (no code gets a random neuron under 13 bits)
+	std::vector<SpikeRecord> sparse;
+	for (uint32_t step(0); step < 5000; ++step) {
+		Philox::Counter random = Philox::generate({{ step, 0, 0, 0 }}, Philox::key(1));
+		std::vector<uint32_t> neurons = { Philox::toIndex(random[0], 12500), Philox::toIndex(random[1], 12500), Philox::toIndex(random[2], 12500) };
+		std::sort(neurons.begin(), neurons.end());
+		for (uint32_t neuron : neurons) {
+			sparse.push_back({ step, neuron });
+		}
+	}
+	std::vector<uint8_t> sparseEncoded;
+	SpikeCodec::encode(sparse.data(), sparse.size(), 0, 12500, sparseEncoded);
+	EXPECT_GT(sparse.size()*sizeof(SpikeRecord), 4*sparseEncoded.size());
+	
+	// an archive of several blocks: only the blocks of a time window are decoded
+	all.clear();
+	for (uint32_t step(0); step < 5000; ++step) {
+		for (uint32_t neuron(step % 7); neuron < 1000; neuron += 97) {
+			all.push_back({ step, neuron });
+		}
+	}
+	{
+		SpikeArchiveWriter writer;
+		EXPECT_TRUE(writer.open("codec_test.spkz", 1000, dt));
+		writer.record(all);
+	}
+	SpikeArchive archive("codec_test.spkz");
+	ASSERT_TRUE(archive.isValid());
+	EXPECT_EQ(all.size(), archive.getHeader().nbRecords);
+	EXPECT_LT(1u, archive.getHeader().nbBlocks);
+	
+	std::vector<SpikeRecord> window;
+	for (auto record : all) {
+		if (record.step >= 1500 and record.step < 3500) {
+			window.push_back(record);
+		}
+	}
+	decoded = archive.decode(150.0, 350.0);
+	ASSERT_EQ(window.size(), decoded.size());
+	for (size_t k(0); k < window.size(); ++k) {
+		EXPECT_EQ(window[k].step, decoded[k].step);
+		EXPECT_EQ(window[k].neuron, decoded[k].neuron);
+	}
+	
+	// a block past the index is rejected with the file, and a corrupt block is not decoded past its bytes
+	{
+		std::ifstream in("codec_test.spkz", std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		SpikeBlock block = archive.getBlock(0);
+		block.nbBytes = archive.getHeader().indexOffset;
+		std::vector<char> corrupt(bytes);
+		memcpy(corrupt.data() + archive.getHeader().indexOffset, &block, sizeof(block));
+		std::ofstream("codec_corrupt.spkz", std::ios::binary).write(corrupt.data(), corrupt.size());
+	}
+	EXPECT_FALSE(SpikeArchive("codec_corrupt.spkz").isValid());
+	std::remove("codec_corrupt.spkz");
+	
+	std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + encoded.size()/2);
+	truncated.insert(truncated.end(), SpikeCodec::Padding, 0);
+	decoded.resize(spikes.size());
+	EXPECT_FALSE(SpikeCodec::decode(truncated.data(), truncated.size(), 3, nbNeurons, decoded.size(), decoded.data()));
+	std::remove("codec_test.spkz");
+}
+
+TEST (CheckpointTest1, bitIdenticalRestart) {
+	
+	for (Connectivity connectivity : { Connectivity::Stored, Connectivity::Procedural }) {
+		// 50 ms at once
+		Network reference(50, 1000, connectivity);
+		reference.update();
+		
+		// 23 ms (not a whole number of windows), saved, then restored in another network with another seed
+		{
+			Network first(23, 1000, connectivity);
+			first.update();
+			EXPECT_TRUE(first.save("checkpoint_test.snapshot"));
+		}
+		Network resumed(50, 1000, connectivity);
+		resumed.setSeed(12);
+		resumed.setNbThreads(2);
+		ASSERT_TRUE(resumed.restore("checkpoint_test.snapshot"));
+		EXPECT_EQ(230u, resumed.getClock());
+		EXPECT_EQ(reference.getSeed(), resumed.getSeed());
+		resumed.update();
+		
+		EXPECT_EQ(reference.getReadBox(), resumed.getReadBox());
+		for (unsigned int i(0); i < 1000; ++i) {
+			EXPECT_EQ(reference.getPopulation().getPotential(i), resumed.getPopulation().getPotential(i));
+			EXPECT_EQ(reference.getPopulation().getNbSpikes(i), resumed.getPopulation().getNbSpikes(i));
+			EXPECT_EQ(reference.getPopulation().getRefractoryTime(i), resumed.getPopulation().getRefractoryTime(i));
+			for (unsigned int slot(0); slot <= DelayStep; ++slot) {
+				EXPECT_EQ(reference.getPopulation().getBuffer(i, slot), resumed.getPopulation().getBuffer(i, slot));
+			}
+		}
+	}
+	
+	// a snapshot of another network size is refused
+	Network other(50, 500);
+	EXPECT_FALSE(other.restore("checkpoint_test.snapshot"));
+	EXPECT_EQ(0u, other.getClock());
+	
+	// periodic snapshots: the snapshot of 10 ms is replaced by the snapshot of 20 ms, then by the end of the simulation
+	{
+		Network periodic(25, 1000);
+		periodic.setCheckpoint("checkpoint_test.snapshot", 10.0);
+		periodic.update();
+	}
+	Network restored(25, 1000);
+	ASSERT_TRUE(restored.restore("checkpoint_test.snapshot"));
+	EXPECT_EQ(250u, restored.getClock());
+	
+	// a truncated snapshot, or an array larger than the file, is refused without allocating it
+	std::ifstream in("checkpoint_test.snapshot", std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	std::ofstream("checkpoint_corrupt.snapshot", std::ios::binary).write(bytes.data(), bytes.size() - 100);
+	EXPECT_FALSE(restored.restore("checkpoint_corrupt.snapshot"));
+	uint64_t size = uint64_t(1) << 60;
+	memcpy(bytes.data() + sizeof(SnapshotHeader) + sizeof(Parameters), &size, sizeof(size));
+	std::ofstream("checkpoint_corrupt.snapshot", std::ios::binary).write(bytes.data(), bytes.size());
+	EXPECT_FALSE(restored.restore("checkpoint_corrupt.snapshot"));
+	EXPECT_EQ(250u, restored.getClock());
+	
+	// a target out of the network, or an unknown storage of the connections, is refused
+	in.clear();
+	in.seekg(0);
+	bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	std::vector<char> corrupt(bytes);
+	uint32_t target = 0x7fffffff;
+	memcpy(corrupt.data() + corrupt.size() - sizeof(target), &target, sizeof(target));
+	std::ofstream("checkpoint_corrupt.snapshot", std::ios::binary).write(corrupt.data(), corrupt.size());
+	EXPECT_FALSE(restored.restore("checkpoint_corrupt.snapshot"));
+	corrupt = bytes;
+	uint32_t connectivity = 2;
+	memcpy(corrupt.data() + offsetof(SnapshotHeader, connectivity), &connectivity, sizeof(connectivity));
+	std::ofstream("checkpoint_corrupt.snapshot", std::ios::binary).write(corrupt.data(), corrupt.size());
+	EXPECT_FALSE(restored.restore("checkpoint_corrupt.snapshot"));
+	EXPECT_EQ(250u, restored.getClock());
+	std::ofstream("checkpoint_corrupt.snapshot", std::ios::binary).write(bytes.data(), bytes.size());
+	EXPECT_TRUE(restored.restore("checkpoint_corrupt.snapshot"));
+	
+	std::remove("checkpoint_corrupt.snapshot");
+	std::remove("checkpoint_test.snapshot");
+}
+
+TEST (SweepTest1, forkedPoints) {
+	
+	// equilibrated snapshot at 20 ms
+	{
+		Network transient(20, 1000);
+		transient.update();
+		EXPECT_TRUE(transient.save("sweep_test.snapshot"));
+	}
+	mkdir("sweep_test", 0755);
+	mkdir("sweep_test_reference", 0755);
+	
+	// reference: the same simulation in this process
+	Network reference(40, 1000);
+	ASSERT_TRUE(reference.restore("sweep_test.snapshot"));
+	ASSERT_TRUE(reference.setOutputDirectory("sweep_test_reference"));
+	reference.update();
+	reference.setOutputDirectory("");
+	
+	// point 0 has the parameters of the snapshot, point 1 other ones
+	Network network(40, 1000);
+	ASSERT_TRUE(network.restore("sweep_test.snapshot"));
+	std::vector<SweepPoint> points = { { g, Eta, network.getExternalSeed() }, { 6.0, 2.5, 7 } };
+	EXPECT_EQ(0u, runForkedSweep(network, points, "sweep_test", 2, 2));
+	
+	// the network of this process is not simulated
+	EXPECT_EQ(200u, network.getClock());
+	
+	auto read = [](const std::string& path) {
+		std::ifstream file(path);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	};
+	std::string rates = read("sweep_test_reference/rates.csv");
+	EXPECT_FALSE(rates.empty());
+	EXPECT_EQ(rates, read(getPointDirectory("sweep_test", 0) + "/rates.csv"));
+	EXPECT_NE(rates, read(getPointDirectory("sweep_test", 1) + "/rates.csv"));
+	
+	for (std::string directory : { getPointDirectory("sweep_test", 0), getPointDirectory("sweep_test", 1), std::string("sweep_test_reference") }) {
+		for (std::string file : { "/spikes.bin", "/spikes2.txt", "/rates.csv" }) {
+			std::remove((directory + file).c_str());
+		}
+		rmdir(directory.c_str());
+	}
+	rmdir("sweep_test");
+	std::remove("sweep_test.snapshot");
+}
+
+TEST (SweepTest2, scheduledGrid) {
+	
+	// g varies the slowest, the seed the fastest
+	SweepGrid grid;
+	EXPECT_TRUE(grid.set("g=3:4:0.5"));
+	EXPECT_TRUE(grid.set("Eta=2,3"));
+	EXPECT_TRUE(grid.set("seed=5"));
+	EXPECT_FALSE(grid.set("g=4:3:0.5"));
+	EXPECT_FALSE(grid.set("tau=1,2"));
+	EXPECT_FALSE(grid.set("seed=-1"));
+	EXPECT_FALSE(grid.set("seed=1.5"));
+	EXPECT_FALSE(grid.set("seed=1e20"));
+	std::vector<SweepPoint> points = grid.getPoints(Parameters());
+	ASSERT_EQ(6u, points.size());
+	EXPECT_EQ(3.5, points[2].g);
+	EXPECT_EQ(2.0, points[2].eta);
+	EXPECT_EQ(4.0, points[5].g);
+	EXPECT_EQ(3.0, points[5].eta);
+	EXPECT_EQ(5u, points[5].seed);
+	
+	// the memory limits the number of networks simulated at the same time, each planned for its duration and rates
+	SweepScheduler scheduler(30, 500);
+	EXPECT_EQ(Network::planMemory(500, Connectivity::Stored, Parameters(), 1, 30, 1.0).getPeak(), scheduler.getNetworkMemory());
+	EXPECT_GT(scheduler.getNetworkMemory(), Network::planMemory(500, Connectivity::Stored).getPeak());
+	scheduler.setNbThreads(4);
+	EXPECT_EQ(4u, scheduler.getNbConcurrent());
+	scheduler.setMemoryLimit(2*scheduler.getNetworkMemory());
+	EXPECT_EQ(2u, scheduler.getNbConcurrent());
+	
+	std::remove("sweep_test.csv");
+	unsigned int nbSimulated;
+	EXPECT_TRUE(scheduler.run(points, "sweep_test.csv", nbSimulated));
+	EXPECT_EQ(6u, nbSimulated);
+	std::vector<SweepSummary> summaries = readSweepSummaries("sweep_test.csv");
+	ASSERT_EQ(6u, summaries.size());
+	
+	// the summary of a point does not depend on the thread which simulated it
+	for (const auto& summary : summaries) {
+		SweepSummary again = scheduler.simulate(summary.point, points[summary.point]);
+		EXPECT_EQ(points[summary.point].g, summary.parameters.g);
+		EXPECT_GT(summary.excitatoryRate, 0.0);
+		EXPECT_NEAR(again.excitatoryRate, summary.excitatoryRate, 1e-4*again.excitatoryRate);
+		EXPECT_NEAR(again.activityCV, summary.activityCV, 1e-4*again.activityCV);
+	}
+	
+	// interrupted sweep: the last point was being written, it is simulated again and only it
+	{
+		std::ifstream file("sweep_test.csv");
+		std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		content.erase(content.size() - 5);
+		std::ofstream truncated("sweep_test.csv", std::ios::trunc);
+		truncated << content;
+	}
+	EXPECT_EQ(5u, readSweepSummaries("sweep_test.csv").size());
+	EXPECT_TRUE(scheduler.run(points, "sweep_test.csv", nbSimulated));
+	EXPECT_EQ(1u, nbSimulated);
+	EXPECT_EQ(6u, readSweepSummaries("sweep_test.csv").size());
+	EXPECT_TRUE(scheduler.run(points, "sweep_test.csv", nbSimulated));
+	EXPECT_EQ(0u, nbSimulated);
+	
+	// a summary file which cannot be written is an error, not a sweep already done
+	EXPECT_FALSE(scheduler.run(points, "no_directory/sweep_test.csv", nbSimulated));
+	EXPECT_EQ(0u, nbSimulated);
+	
+	std::remove("sweep_test.csv");
+}
+
+TEST (ParametersTest1, runtimeParameters) {
+	
+	// assignments of the command line and of a configuration file
+	Parameters parameters;
+	EXPECT_TRUE(parameters.set("g=4.5"));
+	EXPECT_FALSE(parameters.set("g=4.5ms"));
+	EXPECT_FALSE(parameters.set("Unknown=1"));
+	std::istringstream config("# graph D\nEta = 0.9\n\nDelay=2.0\n");
+	EXPECT_TRUE(parameters.read(config));
+	EXPECT_EQ(4.5, parameters.g);
+	EXPECT_EQ(0.9, parameters.eta);
+	EXPECT_EQ(20u, parameters.getDelaySteps());
+	EXPECT_TRUE(parameters.isValid());
+	
+	// the times which are not exact multiples of dt in floating point keep all their steps
+	Parameters rounded;
+	EXPECT_TRUE(rounded.set("Delay=1.2"));
+	EXPECT_TRUE(rounded.set("tauRp=0.7"));
+	EXPECT_EQ(12u, rounded.getDelaySteps());
+	EXPECT_EQ(7u, rounded.getRefractorySteps());
+	EXPECT_TRUE(rounded.set("Delay=0.3"));
+	EXPECT_EQ(3u, rounded.getDelaySteps());
+	
+	// the written parameters are read back unchanged
+	std::ostringstream written;
+	parameters.write(written);
+	Parameters read;
+	std::istringstream in(written.str());
+	EXPECT_TRUE(read.read(in));
+	EXPECT_EQ(0, memcmp(&parameters, &read, sizeof(Parameters)));
+	
+	// the default parameters are the constants: same simulation as the network without parameters
+	Network constants(20, 1000);
+	constants.update();
+	Network defaults(20, 1000, Connectivity::Stored, Parameters());
+	defaults.update();
+	EXPECT_TRUE(getDefaultConstants() == Parameters().getMembraneConstants());
+	for (unsigned int i(0); i < 1000; ++i) {
+		EXPECT_EQ(constants.getPopulation().getPotential(i), defaults.getPopulation().getPotential(i));
+	}
+	
+	// the delay ring and the windows follow the delay
+	Network delayed(20, 1000, Connectivity::Stored, parameters);
+	EXPECT_EQ(20u, delayed.getDelaySteps());
+	EXPECT_EQ(21u, delayed.getPopulation().getNbSlots());
+	EXPECT_EQ(20u, delayed.getWindowSteps());
+	delayed.update();
+	EXPECT_EQ(200u, delayed.getClock());
+	
+	// vectorized kernels with other constants give the same potentials as the scalar kernel
+	Parameters membrane;
+	membrane.threshold = 15.0;
+	membrane.tauRp = 1.0;
+	MembraneConstants constantsOfMembrane = membrane.getMembraneConstants();
+	const unsigned int n(203);
+	std::vector<double> potential(n), iext(n, 0.5), input(n);
+	for (unsigned int i(0); i < n; ++i) {
+		potential[i] = (i*7919 % 300)/10.0 - 5.0;
+		input[i] = static_cast<double>(i % 11) - 5.0;
+	}
+	std::vector<int> scalarRefractory(n, 0);
+	std::vector<double> scalarPotential(potential);
+	std::vector<uint64_t> scalarSpike((n+63)/64, 0);
+	std::vector<unsigned int> scalarNbSpikes(n, 0);
+	MembraneArrays scalar = { scalarPotential.data(), scalarRefractory.data(), iext.data(), input.data(), scalarSpike.data(), scalarNbSpikes.data() };
+	getMembraneKernel(Kernel::Scalar, constantsOfMembrane)(scalar, constantsOfMembrane, 0, n);
+	EXPECT_EQ(9, *std::max_element(scalarRefractory.begin(), scalarRefractory.end()));
+	
+	std::vector<int> vectorRefractory(n, 0);
+	std::vector<double> vectorPotential(potential);
+	std::vector<uint64_t> vectorSpike((n+63)/64, 0);
+	std::vector<unsigned int> vectorNbSpikes(n, 0);
+	MembraneArrays arrays = { vectorPotential.data(), vectorRefractory.data(), iext.data(), input.data(), vectorSpike.data(), vectorNbSpikes.data() };
+	getMembraneKernel(bestKernel(), constantsOfMembrane)(arrays, constantsOfMembrane, 0, n);
+	EXPECT_EQ(scalarPotential, vectorPotential);
+	EXPECT_EQ(scalarRefractory, vectorRefractory);
+	EXPECT_EQ(scalarSpike, vectorSpike);
+}
+
+TEST (ScalingTest1, baselineComparison) {
+	
+	// the forked simulation gives the spikes of the same simulation in the process
+	ScalingConfiguration configuration = { 1000, Connectivity::Procedural, 2 };
+	ScalingResult result;
+	ASSERT_TRUE(runScaling(configuration, 20.0, Parameters(), result));
+	Network network(20.0, 1000, Connectivity::Procedural, Parameters(), Network::DefaultSeed, "");
+	network.update();
+	unsigned long nbSpikes(0);
+	for (unsigned int i(0); i < 1000; ++i) {
+		nbSpikes += network.getPopulation().getNbSpikes(i);
+	}
+	EXPECT_EQ(nbSpikes, result.nbSpikes);
+	EXPECT_EQ(2u, result.configuration.nbThreads);
+	EXPECT_GT(result.peakMemory, 0.0);
+	
+	// weak scaling: the neurons are per thread
+	std::vector<ScalingConfiguration> configurations = getScalingConfigurations({ 100, 200 }, { Connectivity::Stored }, { 1, 4 }, true);
+	ASSERT_EQ(4u, configurations.size());
+	EXPECT_EQ(400u, configurations[1].nbNeurons);
+	EXPECT_EQ(800u, configurations[3].nbNeurons);
+	
+	// the results written are read back, and a run slower than 1 + threshold times the baseline is a regression
+	result.wallSeconds = 0.1;
+	{
+		std::ofstream file("scaling_test.json");
+		writeScalingResults(file, { result });
+	}
+	std::vector<ScalingResult> baseline = readScalingResults("scaling_test.json");
+	remove("scaling_test.json");
+	ASSERT_EQ(1u, baseline.size());
+	EXPECT_EQ(Connectivity::Procedural, baseline[0].configuration.connectivity);
+	EXPECT_EQ(result.nbSpikes, baseline[0].nbSpikes);
+	EXPECT_EQ(20.0, baseline[0].simulatedTime);
+	
+	std::ostringstream report;
+	result.wallSeconds = 0.14;
+	EXPECT_EQ(0u, compareScaling({ result }, baseline, 0.5, report));
+	result.wallSeconds = 0.16;
+	EXPECT_EQ(1u, compareScaling({ result }, baseline, 0.5, report));
+	result.configuration.nbThreads = 1;
+	EXPECT_EQ(0u, compareScaling({ result }, baseline, 0.5, report));
+}
+
+TEST (ProfilerTest1, phaseTimers) {
+	
+	// the phases inside an update are summed and laid one after the other from its start
+	Profiler profiler;
+	profiler.setNbThreads(2);
+	Profiler::Clock::time_point origin = Profiler::Clock::now();
+	auto at = [origin](int microseconds) { return origin + std::chrono::microseconds(microseconds); };
+	profiler.nextWindow();
+	profiler.record(1, Phase::Membrane, at(10), at(12));
+	profiler.record(1, Phase::External, at(12), at(15));
+	profiler.record(1, Phase::Membrane, at(15), at(17));
+	profiler.record(1, Phase::Update, at(10), at(20));
+	profiler.record(0, Phase::Delivery, at(20), at(30));
+	
+	const std::vector<PhaseEvent>& events = profiler.getEvents(1);
+	ASSERT_EQ(3u, events.size());
+	EXPECT_EQ(Phase::Membrane, events[0].phase);
+	EXPECT_EQ(2u, events[0].count);
+	EXPECT_EQ(4000, events[0].duration);
+	EXPECT_EQ(Phase::External, events[1].phase);
+	EXPECT_EQ(events[0].start + 4000, events[1].start);
+	EXPECT_EQ(Phase::Update, events[2].phase);
+	EXPECT_EQ(events[0].start, events[2].start);
+	EXPECT_EQ(1u, events[2].window);
+	EXPECT_DOUBLE_EQ(10e-6, profiler.getTotal(Phase::Delivery));
+	
+	// one complete event per phase interval in the trace, one line per phase in the summary
+	std::ostringstream trace, summary;
+	profiler.writeTrace(trace);
+	EXPECT_NE(std::string::npos, trace.str().find("\"name\": \"External\", \"ph\": \"X\""));
+	profiler.writeSummary(summary);
+	EXPECT_NE(std::string::npos, summary.str().find("Delivery"));
+	EXPECT_EQ(std::string::npos, summary.str().find("Gather"));
+	
+	// the simulation is timed only when compiled with NEURON_PROFILE
+	Network network(20, 1000, Connectivity::Stored, Parameters(), Network::DefaultSeed, "");
+	network.setNbThreads(2);
+	network.update();
+	const Profiler& timed = network.getProfiler();
+	EXPECT_EQ(Profiler::Enabled, timed.getTotal(Phase::Update) > 0.0);
+	EXPECT_EQ(Profiler::Enabled, timed.getTotal(Phase::Connect) > 0.0);
+	if (Profiler::Enabled) {
+		EXPECT_EQ(200u/15 + 1, timed.getNbWindows());
+		EXPECT_FALSE(timed.getEvents(1).empty());
+	}
+}
+
+TEST (PerfCountersTest1, phaseCounters) {
+	
+	// the counters which cannot be opened (virtual machine, perf_event_paranoid) are read as 0
+	PerfCounters counters;
+	uint64_t before[NbCounters], after[NbCounters];
+	bool open = counters.open();
+	EXPECT_EQ(open, counters.read(before));
+	std::vector<double> memory(1 << 20, 1.0);
+	double sum = std::accumulate(memory.begin(), memory.end(), 0.0);
+	EXPECT_EQ(open, counters.read(after));
+	EXPECT_EQ(double(1 << 20), sum);
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		if (counters.isAvailable(static_cast<Counter>(c))) {
+			EXPECT_GE(after[c], before[c]);
+		} else {
+			EXPECT_EQ(0u, after[c]);
+		}
+	}
+	if (counters.isAvailable(Counter::Instructions)) {
+		EXPECT_GT(after[static_cast<unsigned int>(Counter::Instructions)], before[static_cast<unsigned int>(Counter::Instructions)]);
+	}
+	counters.close();
+	EXPECT_FALSE(counters.isOpen());
+	
+	// the events of the phases carry the counters of their thread, or only their time without counters
+	Profiler profiler;
+	EXPECT_EQ(open, profiler.setCounters(true));
+	profiler.setNbThreads(2);
+	// a second thread in the same place, which may get the std::thread::id of the first one, opens its own counters
+	for (unsigned int w(0); w < 2; ++w) {
+		std::thread worker([&profiler]() {
+			// above the largest mmap threshold of malloc: new pages, never memory freed by the previous thread
+			PhaseTimer timer(profiler, Phase::Delivery, 1);
+			std::vector<char> touched(1 << 26, 2);
+			EXPECT_EQ(2, touched.back());
+		});
+		worker.join();
+	}
+	ASSERT_EQ(2u, profiler.getEvents(1).size());
+	for (const PhaseEvent& event : profiler.getEvents(1)) {
+		if (profiler.isAvailable(Counter::PageFaults)) {
+			EXPECT_GT(event.counters[static_cast<unsigned int>(Counter::PageFaults)], 0u);
+		}
+		for (unsigned int c(0); c < NbCounters; ++c) {
+			if (not profiler.isAvailable(static_cast<Counter>(c))) {
+				EXPECT_EQ(0u, event.counters[c]);
+			}
+		}
+	}
+	
+	// the counters opened again during a phase (new threads of the simulation) only give its time
+	{
+		PhaseTimer timer(profiler, Phase::Output, 0);
+		profiler.setNbThreads(2);
+		std::vector<double> touched(1 << 20, 3.0);
+		EXPECT_EQ(3.0, touched.back());
+	}
+	ASSERT_EQ(1u, profiler.getEvents(0).size());
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		EXPECT_EQ(0u, profiler.getEvents(0)[0].counters[c]);
+	}
+	std::ostringstream summary;
+	profiler.writeSummary(summary);
+	EXPECT_EQ(open, summary.str().find("IPC") != std::string::npos);
+	
+	EXPECT_FALSE(profiler.setCounters(false));
+	EXPECT_FALSE(profiler.hasCounters());
+}
+
+TEST (MemoryTest1, memoryReport) {
+	
+	// the plan of a network gives the memory of its structures before they are allocated
+	Parameters parameters;
+	MemoryReport plan = Network::planMemory(1000, Connectivity::Stored, parameters, 2, 20.0);
+	Network network(20.0, 1000, Connectivity::Stored, parameters, Network::DefaultSeed, "");
+	network.setNbThreads(2);
+	network.update();
+	MemoryReport report = network.getMemoryReport();
+	for (const char* name : { "connections", "neurons", "delay ring", "recorder blocks" }) {
+		ASSERT_NE(nullptr, plan.getItem(name));
+		ASSERT_NE(nullptr, report.getItem(name));
+		EXPECT_EQ(plan.getItem(name)->used, report.getItem(name)->used);
+		EXPECT_GE(report.getItem(name)->allocated, report.getItem(name)->used);
+	}
+	EXPECT_EQ(1000*(80u + 20u)*sizeof(unsigned int) + 1001*sizeof(size_t), report.getItem("connections")->used);
+	EXPECT_LE(report.getItem("rates")->used, plan.getItem("rates")->used);
+	EXPECT_LE(report.getItem("spike lists")->allocated, plan.getItem("spike lists")->allocated);
+	EXPECT_EQ(report.getItem("random numbers")->used, plan.getItem("random numbers")->used);
+	EXPECT_GT(plan.getPeak(), plan.getAllocated());
+	
+	// without inhibition the neurons spike together: the lists of the spikes still fit in the plan
+	Parameters synchronous;
+	synchronous.g = 0.0;
+	MemoryReport synchronousPlan = Network::planMemory(2000, Connectivity::Stored, synchronous, 2, 200.0);
+	Network synchronousNetwork(200.0, 2000, Connectivity::Stored, synchronous, Network::DefaultSeed, "");
+	synchronousNetwork.setNbThreads(2);
+	synchronousNetwork.update();
+	MemoryReport synchronousReport = synchronousNetwork.getMemoryReport();
+	EXPECT_LE(synchronousReport.getItem("spike lists")->allocated, synchronousPlan.getItem("spike lists")->allocated);
+	EXPECT_LE(synchronousReport.getAllocated(), synchronousPlan.getAllocated());
+	
+	// the procedural connections are not stored, and the slack of the vectors is counted
+	EXPECT_EQ(nullptr, Network::planMemory(1000, Connectivity::Procedural, parameters).getItem("connections"));
+	MemoryReport vectors;
+	std::vector<double> values;
+	values.reserve(10);
+	values.push_back(1.0);
+	vectors.add("values", values);
+	vectors.add("values", 8, 8);
+	EXPECT_EQ(16u, vectors.getUsed());
+	EXPECT_EQ(88u, vectors.getAllocated());
+	std::ostringstream table;
+	vectors.write(table);
+	EXPECT_NE(std::string::npos, table.str().find("values"));
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
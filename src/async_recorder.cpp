@@ -0,0 +1,270 @@
+#include "async_recorder.hpp"
+
+using namespace std;
+
+//======================================================================
+//constructeurs/destructeurs
+AsyncRecorder::AsyncRecorder(size_t capacity)
+: full_(capacity), empty_(capacity + 2), current_(nullptr), backpressure_(Backpressure::Block),
+  nbHandedOver_(0), nbWritten_(0), stop_(false), nbNeurons_(0), dt_(0.0),
+  nbDroppedBlocks_(0), nbDroppedSpikes_(0), nbDroppedTotals_(0)
+{
+	// the ring, the block being written and the current block: at least one block is always empty
+	for (size_t b(0); b < capacity + 2; ++b) {
+		blocks_.push_back(unique_ptr<RecordBlock>(new RecordBlock()));
+		blocks_.back()->spikes.reserve(SpikeRecorder::BlockRecords);
+		blocks_.back()->totals.reserve(SpikeRecorder::BlockRecords);
+		blocks_.back()->flush = false;
+		empty_.push(blocks_.back().get());
+	}
+	empty_.pop(current_);
+}
+//----------------------------------------------------------------------
+AsyncRecorder::~AsyncRecorder()
+{
+	close();
+}
+//======================================================================
+bool AsyncRecorder::open(const string& spikesPath, const string& totalsPath, unsigned int nbNeurons, double dt)
+{
+	close();
+	
+	dt_ = dt;
+	nbNeurons_ = nbNeurons;
+	bool opened = spikesFile_.open(spikesPath, nbNeurons, dt);
+	
+	totalsFile_.open(totalsPath);
+	if (totalsFile_.fail()) {
+		opened = false;
+	} else {
+		totalsFile_ << "dt,spikes" << '\n';
+	}
+	
+	// without its files the recorder stays closed and ignores the records
+	if (not opened) {
+		spikesFile_.close();
+		totalsFile_.close();
+		return false;
+	}
+	
+	stop_ = false;
+	writer_ = thread(&AsyncRecorder::work, this);
+	return true;
+}
+//----------------------------------------------------------------------
+bool AsyncRecorder::openStore(const string& path, unsigned int chunkSteps)
+{
+	if (not isOpen()) {
+		return false;
+	}
+	
+	// the writer has nothing left to write: it does not touch the store while it is opened
+	flush();
+	return store_.open(path, nbNeurons_, dt_, chunkSteps);
+}
+//----------------------------------------------------------------------
+bool AsyncRecorder::openArchive(const string& path)
+{
+	if (not isOpen()) {
+		return false;
+	}
+	
+	flush();
+	return archive_.open(path, nbNeurons_, dt_);
+}
+//----------------------------------------------------------------------
+bool AsyncRecorder::isOpen() const
+{
+	return writer_.joinable();
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::recordSpikes(unsigned long step, const vector<unsigned int>& neurons)
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	for (auto neuron : neurons) {
+		current_->spikes.push_back({ static_cast<uint32_t>(step), neuron });
+		
+		if (current_->spikes.size() == SpikeRecorder::BlockRecords) {
+			handOver(backpressure_);
+		}
+	}
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::recordTotal(unsigned long step, unsigned int nbSpikes)
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	current_->totals.push_back({ step, nbSpikes });
+	
+	if (current_->totals.size() == SpikeRecorder::BlockRecords) {
+		handOver(backpressure_);
+	}
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::flush()
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	current_->flush = true;
+	handOver(Backpressure::Block);
+	
+	unique_lock<mutex> lock(mutex_);
+	written_.wait(lock, [this]() { return nbWritten_.load(memory_order_acquire) >= nbHandedOver_; });
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::close()
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	handOver(Backpressure::Block);
+	
+	// the writer empties the ring before it ends
+	{
+		lock_guard<mutex> lock(mutex_);
+		stop_.store(true, memory_order_release);
+	}
+	wake_.notify_one();
+	writer_.join();
+	
+	spikesFile_.close();
+	totalsFile_.close();
+	store_.close();
+	archive_.close();
+}
+//======================================================================
+Backpressure AsyncRecorder::getBackpressure() const
+{
+	return backpressure_;
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::setBackpressure(Backpressure backpressure)
+{
+	backpressure_ = backpressure;
+}
+//----------------------------------------------------------------------
+unsigned long AsyncRecorder::getNbDroppedBlocks() const
+{
+	return nbDroppedBlocks_;
+}
+//----------------------------------------------------------------------
+unsigned long AsyncRecorder::getNbDroppedSpikes() const
+{
+	return nbDroppedSpikes_;
+}
+//----------------------------------------------------------------------
+unsigned long AsyncRecorder::getNbDroppedTotals() const
+{
+	return nbDroppedTotals_;
+}
+//======================================================================
+//Simulation thread
+void AsyncRecorder::handOver(Backpressure backpressure)
+{
+	if (current_->spikes.empty() and current_->totals.empty() and not current_->flush) {
+		return;
+	}
+	
+	unsigned long nbWritten = nbWritten_.load(memory_order_acquire);
+	while (not full_.push(current_)) {
+		if (backpressure == Backpressure::Drop) {
+			++nbDroppedBlocks_;
+			nbDroppedSpikes_ += current_->spikes.size();
+			nbDroppedTotals_ += current_->totals.size();
+			current_->spikes.clear();
+			current_->totals.clear();
+			return;
+		}
+		// the writer is late: the simulation sleeps until it has written a block
+		waitWritten(nbWritten);
+		nbWritten = nbWritten_.load(memory_order_acquire);
+	}
+	++nbHandedOver_;
+	{
+		// the writer cannot miss the block between its test of the ring and its sleep
+		lock_guard<mutex> lock(mutex_);
+	}
+	wake_.notify_one();
+	
+	// a block written by the writer (there is always one, see the constructor)
+	while (not empty_.pop(current_)) {
+		waitWritten(nbWritten);
+		nbWritten = nbWritten_.load(memory_order_acquire);
+	}
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::waitWritten(unsigned long nbWritten)
+{
+	unique_lock<mutex> lock(mutex_);
+	written_.wait(lock, [this, nbWritten]() { return nbWritten_.load(memory_order_acquire) > nbWritten; });
+}
+//======================================================================
+//Writer thread
+void AsyncRecorder::work()
+{
+	RecordBlock* block;
+	
+	while (true) {
+		if (full_.pop(block)) {
+			write(*block);
+			
+			block->spikes.clear();
+			block->totals.clear();
+			block->flush = false;
+			empty_.push(block);
+			{
+				lock_guard<mutex> lock(mutex_);
+				nbWritten_.fetch_add(1, memory_order_release);
+			}
+			written_.notify_all();
+			
+		} else {
+			// the ring is empty: the writer sleeps until a block is handed over or the recorder is closed
+			unique_lock<mutex> lock(mutex_);
+			wake_.wait(lock, [this]() { return not full_.empty() or stop_.load(memory_order_acquire); });
+			
+			// every block was handed over before the stop: the ring is empty for good
+			if (full_.empty()) {
+				return;
+			}
+		}
+	}
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::write(const RecordBlock& block)
+{
+	spikesFile_.record(block.spikes);
+	store_.record(block.spikes);
+	archive_.record(block.spikes);
+	
+	for (const auto& total : block.totals) {
+		totalsFile_ << total.step*dt_ << " " << total.nbSpikes << '\n';
+	}
+	
+	if (block.flush) {
+		spikesFile_.flush();
+		totalsFile_.flush();
+	}
+}
+//======================================================================
+//Memory
+size_t AsyncRecorder::getBlockMemory(size_t capacity)
+{
+	// the blocks are reserved once and never grow: the writer gets a block when it is full
+	return (capacity + 2)*SpikeRecorder::BlockRecords*(sizeof(SpikeRecord) + sizeof(StepTotal));
+}
+//----------------------------------------------------------------------
+void AsyncRecorder::reportMemory(MemoryReport& report) const
+{
+	size_t memory = getBlockMemory(blocks_.size() - 2);
+	report.add("recorder blocks", memory, memory);
+}
+//======================================================================
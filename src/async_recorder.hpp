@@ -0,0 +1,244 @@
+#ifndef async_recorder_H
+#define async_recorder_H
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include "spike_recorder.hpp"
+#include "spike_store.hpp"
+#include "spike_codec.hpp"
+#include "spsc_ring.hpp"
+#include "memory_report.hpp"
+
+/**
+ * @brief Behaviour of the recorder when the writer thread is late and its ring is full.
+ *
+ * Block: the simulation waits for the writer (nothing is lost).
+ * Drop: the block of records is dropped and counted (the simulation never waits).
+ */
+enum class Backpressure { Block, Drop };
+
+/**
+ * @brief Total number of spikes of a step.
+ */
+struct StepTotal {
+	unsigned long step; //!< Step time
+	unsigned int nbSpikes; //!< Number of spikes of all the neurons during the step
+};
+
+/**
+ * @brief Block of records handed over to the writer thread.
+ */
+struct RecordBlock {
+	std::vector<SpikeRecord> spikes; //!< Spikes, in order of time
+	std::vector<StepTotal> totals; //!< Totals of spikes per step, in order of time
+	bool flush; //!< Whether the files must be flushed once the block is written
+};
+
+/*!
+ * @class AsyncRecorder
+ *
+ * @brief Records the spikes of a simulation from a dedicated writer thread.
+ *
+ * The simulation (producer) fills a block of records in memory. A full block is handed over to the writer thread
+ * (consumer) through a lock-free ring, and the writer gives the written blocks back through a second ring:
+ * the blocks are allocated once. The writer writes the spikes into the binary spike file (see SpikeRecorder)
+ * and the totals per step into the text file for gnuplot, so a slow disk never stalls the simulation
+ * unless the ring is full (see Backpressure).
+ *
+ * @note All the methods must be called from the same (simulation) thread.
+ */
+class AsyncRecorder {
+
+public:
+	static const size_t DefaultCapacity = 8; //!< Number of blocks waiting for the writer by default
+
+	/**
+	 * @brief Constructor: the recorder ignores the records until the files are opened.
+	 *
+	 * @param capacity is the number of blocks waiting for the writer before the backpressure applies. Default value = 8
+	 */
+	AsyncRecorder(size_t capacity = DefaultCapacity);
+
+	/**
+	 * @brief Destructor
+	 *
+	 * @note All the records accepted are written before the files are closed (see close).
+	 */
+	~AsyncRecorder();
+
+	AsyncRecorder(const AsyncRecorder&) = delete;
+	AsyncRecorder& operator=(const AsyncRecorder&) = delete;
+
+	/**
+	 * @brief Open the files and start the writer thread.
+	 *
+	 * @param spikesPath is the path of the binary spike file
+	 * @param totalsPath is the path of the text file of the totals per step ("dt,spikes" header, one line "time count" per step)
+	 * @param nbNeurons is the number of neurons of the network
+	 * @param dt is the step time (ms)
+	 *
+	 * @return whether both files could be opened (otherwise the writer thread is not started and the recorder stays closed)
+	 */
+	bool open(const std::string& spikesPath, const std::string& totalsPath, unsigned int nbNeurons, double dt);
+
+	/**
+	 * @brief Also write the spikes into a spike store, indexed by time and neuron (see SpikeStoreWriter).
+	 *
+	 * @param path is the path of the store
+	 * @param chunkSteps is the number of steps of the window of a chunk
+	 *
+	 * @return whether the store could be opened
+	 *
+	 * @note The recorder must be open. The store is complete once the recorder is closed.
+	 */
+	bool openStore(const std::string& path, unsigned int chunkSteps);
+
+	/**
+	 * @brief Also write the spikes into a compressed spike archive (see SpikeArchiveWriter).
+	 *
+	 * @note The recorder must be open. The archive is complete once the recorder is closed.
+	 */
+	bool openArchive(const std::string& path);
+
+	/**
+	 * @brief Whether the files are open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Record the spikes of a step.
+	 *
+	 * @param step is the step time of the spikes
+	 * @param neurons are the neurons that spiked
+	 */
+	void recordSpikes(unsigned long step, const std::vector<unsigned int>& neurons);
+
+	/**
+	 * @brief Record the total number of spikes of a step.
+	 */
+	void recordTotal(unsigned long step, unsigned int nbSpikes);
+
+	/**
+	 * @brief Hand over the current block and wait until the writer has written and flushed everything.
+	 */
+	void flush();
+
+	/**
+	 * @brief Write everything, stop the writer thread and close the files.
+	 *
+	 * @note The last block is handed over with Backpressure::Block whatever the backpressure: the drain is complete.
+	 */
+	void close();
+
+	/**
+	 * @brief Get the behaviour when the ring is full.
+	 */
+	Backpressure getBackpressure() const;
+
+	/**
+	 * @brief Set the behaviour when the ring is full. Default value = Block
+	 */
+	void setBackpressure(Backpressure backpressure);
+
+	/**
+	 * @brief Get the number of blocks dropped because the ring was full.
+	 */
+	unsigned long getNbDroppedBlocks() const;
+
+	/**
+	 * @brief Get the number of spikes dropped because the ring was full.
+	 */
+	unsigned long getNbDroppedSpikes() const;
+
+	/**
+	 * @brief Get the number of step totals dropped because the ring was full.
+	 */
+	unsigned long getNbDroppedTotals() const;
+
+	/**
+	 * @brief Add the memory of the blocks of records ("recorder blocks") to a report.
+	 *
+	 * @note The buffers of the files, owned by the writer thread, are not counted.
+	 */
+	void reportMemory(MemoryReport& report) const;
+
+	/**
+	 * @brief Get the memory of the blocks of records of a recorder, allocated by its constructor (bytes).
+	 *
+	 * @param capacity is the capacity of the recorder
+	 */
+	static size_t getBlockMemory(size_t capacity = DefaultCapacity);
+
+private:
+
+	/**
+	 * @brief Hand over the current block to the writer and take an empty one.
+	 *
+	 * @param backpressure is the behaviour if the ring is full
+	 */
+	void handOver(Backpressure backpressure);
+
+	/**
+	 * @brief Main loop of the writer thread: write the blocks until the recorder is closed and the ring is empty.
+	 */
+	void work();
+
+	/**
+	 * @brief Write one block into the files (writer thread).
+	 */
+	void write(const RecordBlock& block);
+
+	/**
+	 * @brief Wait until the writer has written more than nbWritten blocks (simulation thread).
+	 */
+	void waitWritten(unsigned long nbWritten);
+
+	std::vector<std::unique_ptr<RecordBlock> > blocks_; //!< All the blocks, allocated once
+
+	SpscRing<RecordBlock*> full_; //!< Blocks handed over to the writer
+
+	SpscRing<RecordBlock*> empty_; //!< Blocks written, given back to the simulation
+
+	RecordBlock* current_; //!< Block filled by the simulation
+
+	Backpressure backpressure_; //!< Behaviour when full_ is full
+
+	unsigned long nbHandedOver_; //!< Number of blocks handed over to the writer
+
+	std::atomic<unsigned long> nbWritten_; //!< Number of blocks written by the writer
+
+	std::atomic<bool> stop_; //!< Whether the writer must end once the ring is empty
+
+	std::mutex mutex_; //!< Guards the sleeps of the two threads (the rings themselves need no lock)
+
+	std::condition_variable wake_; //!< Wakes the writer when a block is handed over or the recorder is closed
+
+	std::condition_variable written_; //!< Wakes the simulation when the writer has written a block
+
+	std::thread writer_; //!< Writer thread
+
+	SpikeRecorder spikesFile_; //!< Binary spike file, written by the writer
+
+	std::ofstream totalsFile_; //!< Totals per step, written by the writer
+
+	SpikeStoreWriter store_; //!< Spike store, written by the writer (if open)
+
+	SpikeArchiveWriter archive_; //!< Compressed spike archive, written by the writer (if open)
+
+	unsigned int nbNeurons_; //!< Number of neurons of the network
+
+	double dt_; //!< Step time (ms)
+
+	unsigned long nbDroppedBlocks_; //!< Number of blocks dropped
+
+	unsigned long nbDroppedSpikes_; //!< Number of spikes dropped
+
+	unsigned long nbDroppedTotals_; //!< Number of totals dropped
+};
+
+#endif
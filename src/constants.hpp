@@ -0,0 +1,27 @@
+#ifndef constants_H
+#define constants_H
+#include <cmath>
+
+///Constants
+
+const double g = 5.0;							//!< Relative strength of inhibitory synapses
+const double Eta = 2.0;							//!< Eta function
+
+const double Threshold = 20.0; 					//!< Maximum potential limit [mV]
+const double PotentialReset = 0.0; 				//!< Potential reset  [mV]
+const double dt = 0.1; 							//!< Time variation [ms]
+const unsigned int h = 1; 						//!< Steptime (will be converted en ms)
+const double Resistance = 20.0; 				//!< Membrane Resistance [Ohm]
+const double Capacity = 1.0; 					//!< Capacity [Farrad]
+const double tau = Resistance * Capacity; 		//!< Tau excitatory
+const double e = exp(-dt/tau);					//!< needed for the membrane equation
+const double OneMinus_e = 1 - e;				//!< needed for the membrane equation 
+const double tauRp = 2.0; 						//!< Refractory time period [ms]
+const double Amplitude = 0.1; 					//!< Spike Amplitude received from excitatory neurons
+const double Delay = 1.5; 						//!< Transmission delay [ms]
+const double ConnectionPercent = 0.1;			//!< Connections pourcentage in the whole network
+const double Vext = Threshold * Eta /(Amplitude*tau); //!< External frequency
+const unsigned int DelayStep = static_cast<unsigned long>(floor(Delay/dt)); //!< Delay in steps
+const unsigned int RefractoryStep = static_cast<unsigned long>(floor(tauRp/dt)); //!< Refractory period in steps
+
+#endif
@@ -0,0 +1,296 @@
+#include "kernel.hpp"
+#include "constants.hpp"
+#include <cassert>
+
+// This file is compiled with -ffp-contract=off: the multiplications and additions of the vectorized kernels
+// must not be fused (AVX-512 implies FMA), so that they give exactly the same potentials as the scalar kernel.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NEURON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//======================================================================
+//Constants of the membrane equation
+MembraneConstants getDefaultConstants()
+{
+	return { Threshold, PotentialReset, e, Resistance, OneMinus_e, Amplitude, static_cast<int>(RefractoryStep) };
+}
+//----------------------------------------------------------------------
+bool operator==(const MembraneConstants& a, const MembraneConstants& b)
+{
+	return a.threshold == b.threshold and a.reset == b.reset and a.decay == b.decay and a.resistance == b.resistance
+	       and a.oneMinusDecay == b.oneMinusDecay and a.amplitude == b.amplitude and a.refractorySteps == b.refractorySteps;
+}
+//----------------------------------------------------------------------
+// Constants of constants.hpp, known by the compiler
+struct FixedConstants {
+	FixedConstants(const MembraneConstants&) {}
+	double threshold() const { return Threshold; }
+	double reset() const { return PotentialReset; }
+	double decay() const { return e; }
+	double resistance() const { return Resistance; }
+	double oneMinusDecay() const { return OneMinus_e; }
+	double amplitude() const { return Amplitude; }
+	int refractorySteps() const { return RefractoryStep; }
+};
+//----------------------------------------------------------------------
+// Constants given at runtime
+struct RuntimeConstants {
+	RuntimeConstants(const MembraneConstants& constants) : c(constants) {}
+	double threshold() const { return c.threshold; }
+	double reset() const { return c.reset; }
+	double decay() const { return c.decay; }
+	double resistance() const { return c.resistance; }
+	double oneMinusDecay() const { return c.oneMinusDecay; }
+	double amplitude() const { return c.amplitude; }
+	int refractorySteps() const { return c.refractorySteps; }
+	const MembraneConstants c;
+};
+//======================================================================
+//Scalar kernel
+template <class Constants>
+static void updateScalar(const MembraneArrays& a, const MembraneConstants& constants, unsigned int begin, unsigned int end)
+{
+	const Constants c(constants);
+	
+	for (unsigned int i(begin); i < end; ++i) {
+		a.spikeMask[i/64] &= ~(uint64_t(1) << (i%64));
+
+		if (a.refractoryTime[i] > 0) {
+			a.potential[i] = c.reset();
+			--a.refractoryTime[i];
+
+		} else if (a.potential[i] > c.threshold()) {
+			a.spikeMask[i/64] |= uint64_t(1) << (i%64);
+			++a.nbSpikes[i];
+			a.refractoryTime[i] = c.refractorySteps() -1;
+
+		} else {
+			a.potential[i] = c.decay()*a.potential[i] + a.iext[i]*c.resistance()*c.oneMinusDecay() + a.input[i]*c.amplitude();
+		}
+	}
+}
+//----------------------------------------------------------------------
+// Record of the spikes of a group of lanes: bit l of mask is the spike of neuron i+l
+static inline void recordSpikes(const MembraneArrays& a, unsigned int i, unsigned int lanes, uint64_t mask)
+{
+	uint64_t lanesMask = (uint64_t(1) << lanes) - 1;
+	
+	if (i%64 + lanes <= 64) {
+		// the lanes are in the same word of the spike mask
+		a.spikeMask[i/64] = (a.spikeMask[i/64] & ~(lanesMask << (i%64))) | (mask << (i%64));
+	} else {
+		for (unsigned int l(0); l < lanes; ++l) {
+			unsigned int j = i + l;
+			a.spikeMask[j/64] = (a.spikeMask[j/64] & ~(uint64_t(1) << (j%64))) | (((mask >> l) & 1) << (j%64));
+		}
+	}
+	
+	// the spikes are rare: only the set bits are visited
+	while (mask != 0) {
+		++a.nbSpikes[i + __builtin_ctzll(mask)];
+		mask &= mask - 1;
+	}
+}
+//======================================================================
+#ifdef NEURON_X86_KERNELS
+//SSE2 kernel: 2 neurons per instruction
+template <class Constants>
+__attribute__((target("sse2")))
+static void updateSSE2(const MembraneArrays& a, const MembraneConstants& constants, unsigned int begin, unsigned int end)
+{
+	const Constants c(constants);
+	const __m128d reset = _mm_set1_pd(c.reset());
+	const __m128d threshold = _mm_set1_pd(c.threshold());
+	const __m128d decay = _mm_set1_pd(c.decay());
+	const __m128d resistance = _mm_set1_pd(c.resistance());
+	const __m128d oneMinusDecay = _mm_set1_pd(c.oneMinusDecay());
+	const __m128d amplitude = _mm_set1_pd(c.amplitude());
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d refractoryStep = _mm_set1_pd(c.refractorySteps() -1);
+
+	unsigned int i(begin);
+	for (; i + 2 <= end; i += 2) {
+		__m128d potential = _mm_loadu_pd(a.potential + i);
+		__m128d refractory = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a.refractoryTime + i)));
+
+		__m128d isRefractory = _mm_cmpgt_pd(refractory, zero);
+		__m128d isSpiking = _mm_andnot_pd(isRefractory, _mm_cmpgt_pd(potential, threshold));
+
+		// membrane equation, in the same order of operations as the scalar kernel
+		__m128d current = _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(a.iext + i), resistance), oneMinusDecay);
+		__m128d membrane = _mm_add_pd(_mm_add_pd(_mm_mul_pd(decay, potential), current), _mm_mul_pd(_mm_loadu_pd(a.input + i), amplitude));
+
+		// refractory: reset / spiking: unchanged / otherwise: membrane equation
+		potential = _mm_or_pd(_mm_and_pd(isSpiking, potential), _mm_andnot_pd(isSpiking, membrane));
+		potential = _mm_or_pd(_mm_and_pd(isRefractory, reset), _mm_andnot_pd(isRefractory, potential));
+		_mm_storeu_pd(a.potential + i, potential);
+
+		// refractory: decremented / spiking: refractory period / otherwise: unchanged
+		__m128d spikingRefractory = _mm_or_pd(_mm_and_pd(isSpiking, refractoryStep), _mm_andnot_pd(isSpiking, refractory));
+		refractory = _mm_or_pd(_mm_and_pd(isRefractory, _mm_sub_pd(refractory, one)), _mm_andnot_pd(isRefractory, spikingRefractory));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(a.refractoryTime + i), _mm_cvttpd_epi32(refractory));
+
+		recordSpikes(a, i, 2, _mm_movemask_pd(isSpiking));
+	}
+	updateScalar<Constants>(a, constants, i, end);
+}
+//----------------------------------------------------------------------
+//AVX2 kernel: 4 neurons per instruction
+template <class Constants>
+__attribute__((target("avx2")))
+static void updateAVX2(const MembraneArrays& a, const MembraneConstants& constants, unsigned int begin, unsigned int end)
+{
+	const Constants c(constants);
+	const __m256d reset = _mm256_set1_pd(c.reset());
+	const __m256d threshold = _mm256_set1_pd(c.threshold());
+	const __m256d decay = _mm256_set1_pd(c.decay());
+	const __m256d resistance = _mm256_set1_pd(c.resistance());
+	const __m256d oneMinusDecay = _mm256_set1_pd(c.oneMinusDecay());
+	const __m256d amplitude = _mm256_set1_pd(c.amplitude());
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d one = _mm256_set1_pd(1.0);
+	const __m256d refractoryStep = _mm256_set1_pd(c.refractorySteps() -1);
+
+	unsigned int i(begin);
+	for (; i + 4 <= end; i += 4) {
+		__m256d potential = _mm256_loadu_pd(a.potential + i);
+		__m256d refractory = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.refractoryTime + i)));
+
+		__m256d isRefractory = _mm256_cmp_pd(refractory, zero, _CMP_GT_OQ);
+		__m256d isSpiking = _mm256_andnot_pd(isRefractory, _mm256_cmp_pd(potential, threshold, _CMP_GT_OQ));
+
+		__m256d current = _mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(a.iext + i), resistance), oneMinusDecay);
+		__m256d membrane = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(decay, potential), current), _mm256_mul_pd(_mm256_loadu_pd(a.input + i), amplitude));
+
+		// refractory: reset / spiking: unchanged / otherwise: membrane equation
+		potential = _mm256_blendv_pd(membrane, potential, isSpiking);
+		potential = _mm256_blendv_pd(potential, reset, isRefractory);
+		_mm256_storeu_pd(a.potential + i, potential);
+
+		// refractory: decremented / spiking: refractory period / otherwise: unchanged
+		refractory = _mm256_blendv_pd(_mm256_blendv_pd(refractory, refractoryStep, isSpiking), _mm256_sub_pd(refractory, one), isRefractory);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(a.refractoryTime + i), _mm256_cvttpd_epi32(refractory));
+
+		recordSpikes(a, i, 4, _mm256_movemask_pd(isSpiking));
+	}
+	updateScalar<Constants>(a, constants, i, end);
+}
+//----------------------------------------------------------------------
+//AVX-512 kernel: 8 neurons per instruction
+//(masked conversions: the unmasked ones read an undefined register)
+template <class Constants>
+__attribute__((target("avx512f")))
+static void updateAVX512(const MembraneArrays& a, const MembraneConstants& constants, unsigned int begin, unsigned int end)
+{
+	const Constants c(constants);
+	const __m512d reset = _mm512_set1_pd(c.reset());
+	const __m512d threshold = _mm512_set1_pd(c.threshold());
+	const __m512d decay = _mm512_set1_pd(c.decay());
+	const __m512d resistance = _mm512_set1_pd(c.resistance());
+	const __m512d oneMinusDecay = _mm512_set1_pd(c.oneMinusDecay());
+	const __m512d amplitude = _mm512_set1_pd(c.amplitude());
+	const __m512d zero = _mm512_setzero_pd();
+	const __m512d one = _mm512_set1_pd(1.0);
+	const __m512d refractoryStep = _mm512_set1_pd(c.refractorySteps() -1);
+
+	unsigned int i(begin);
+	for (; i + 8 <= end; i += 8) {
+		__m512d potential = _mm512_loadu_pd(a.potential + i);
+		__m512d refractory = _mm512_maskz_cvtepi32_pd(0xFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.refractoryTime + i)));
+
+		__mmask8 isRefractory = _mm512_cmp_pd_mask(refractory, zero, _CMP_GT_OQ);
+		__mmask8 isSpiking = _mm512_kandn(isRefractory, _mm512_cmp_pd_mask(potential, threshold, _CMP_GT_OQ));
+
+		__m512d current = _mm512_mul_pd(_mm512_mul_pd(_mm512_loadu_pd(a.iext + i), resistance), oneMinusDecay);
+		__m512d membrane = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(decay, potential), current), _mm512_mul_pd(_mm512_loadu_pd(a.input + i), amplitude));
+
+		// refractory: reset / spiking: unchanged / otherwise: membrane equation
+		potential = _mm512_mask_blend_pd(isSpiking, membrane, potential);
+		potential = _mm512_mask_blend_pd(isRefractory, potential, reset);
+		_mm512_storeu_pd(a.potential + i, potential);
+
+		// refractory: decremented / spiking: refractory period / otherwise: unchanged
+		refractory = _mm512_mask_blend_pd(isSpiking, refractory, refractoryStep);
+		refractory = _mm512_mask_sub_pd(refractory, isRefractory, refractory, one);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(a.refractoryTime + i), _mm512_maskz_cvttpd_epi32(0xFF, refractory));
+
+		recordSpikes(a, i, 8, isSpiking);
+	}
+	updateScalar<Constants>(a, constants, i, end);
+}
+#endif
+//======================================================================
+//Runtime dispatch
+bool isSupported(Kernel kernel)
+{
+	switch (kernel) {
+		case Kernel::Scalar:
+			return true;
+#ifdef NEURON_X86_KERNELS
+		case Kernel::SSE2:
+			return __builtin_cpu_supports("sse2");
+		case Kernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+		case Kernel::AVX512:
+			return __builtin_cpu_supports("avx512f");
+#endif
+		default:
+			return false;
+	}
+}
+//----------------------------------------------------------------------
+Kernel bestKernel()
+{
+	for (Kernel kernel : { Kernel::AVX512, Kernel::AVX2, Kernel::SSE2 }) {
+		if (isSupported(kernel)) {
+			return kernel;
+		}
+	}
+	return Kernel::Scalar;
+}
+//----------------------------------------------------------------------
+template <class Constants>
+static MembraneKernel getMembraneKernel(Kernel kernel)
+{
+	switch (kernel) {
+#ifdef NEURON_X86_KERNELS
+		case Kernel::SSE2:
+			return updateSSE2<Constants>;
+		case Kernel::AVX2:
+			return updateAVX2<Constants>;
+		case Kernel::AVX512:
+			return updateAVX512<Constants>;
+#endif
+		default:
+			return updateScalar<Constants>;
+	}
+}
+//----------------------------------------------------------------------
+MembraneKernel getMembraneKernel(Kernel kernel, const MembraneConstants& constants)
+{
+	assert(isSupported(kernel));
+
+	if (constants == getDefaultConstants()) {
+		return getMembraneKernel<FixedConstants>(kernel);
+	}
+	return getMembraneKernel<RuntimeConstants>(kernel);
+}
+//----------------------------------------------------------------------
+string getName(Kernel kernel)
+{
+	switch (kernel) {
+		case Kernel::SSE2:
+			return "SSE2";
+		case Kernel::AVX2:
+			return "AVX2";
+		case Kernel::AVX512:
+			return "AVX-512";
+		default:
+			return "scalar";
+	}
+}
+//======================================================================
@@ -0,0 +1,96 @@
+#ifndef kernel_H
+#define kernel_H
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Instruction sets of the membrane kernels
+ *
+ * Scalar: one neuron at a time (any processor).
+ * SSE2: 2 neurons per instruction. AVX2: 4 neurons per instruction. AVX512: 8 neurons per instruction.
+ *
+ * @note The potentials are in double precision, hence 2, 4 or 8 neurons per 128, 256 or 512 bits register.
+ */
+enum class Kernel { Scalar, SSE2, AVX2, AVX512 };
+
+/**
+ * @brief Arrays of the population read and written by the membrane kernel.
+ *
+ * Entry i of each array belongs to neuron i.
+ */
+struct MembraneArrays {
+	double* potential; //!< Membrane potentials
+	int* refractoryTime; //!< Refractory timers
+	const double* iext; //!< External currents
+	const double* input; //!< Slot of the delay ring read at this step
+	uint64_t* spikeMask; //!< Spike states: bit i%64 of word i/64 is set if neuron i spikes
+	unsigned int* nbSpikes; //!< Numbers of spikes
+};
+
+/**
+ * @brief Parameters of the membrane equation read by the membrane kernel.
+ *
+ * The default values are those of constants.hpp (see getDefaultConstants).
+ */
+struct MembraneConstants {
+	double threshold; //!< Maximum potential limit
+	double reset; //!< Potential of the refractory neurons
+	double decay; //!< Decay of the potential during a step (e)
+	double resistance; //!< Membrane resistance
+	double oneMinusDecay; //!< 1 - decay
+	double amplitude; //!< Amplitude of the spikes received
+	int refractorySteps; //!< Refractory period in steps
+};
+
+/**
+ * @brief Get the parameters of the membrane equation of constants.hpp.
+ */
+MembraneConstants getDefaultConstants();
+
+/**
+ * @brief Whether two sets of parameters of the membrane equation are identical.
+ */
+bool operator==(const MembraneConstants& a, const MembraneConstants& b);
+
+/**
+ * @brief Membrane kernel: updates the neurons of [begin, end).
+ *
+ * For each neuron:
+ * if the neuron is refractory, the potential is reset and the refractory time decremented,
+ * else if the potential is greater than the threshold, the neuron spikes and becomes refractory,
+ * otherwise the membrane equation gives the new potential.
+ *
+ * The vectorized kernels compute the three cases for all the lanes and select the result with masks.
+ * They give exactly the same potentials as the scalar kernel.
+ * The comparison with the threshold directly gives the bits of the spike mask of the lanes.
+ */
+typedef void (*MembraneKernel)(const MembraneArrays& arrays, const MembraneConstants& constants, unsigned int begin, unsigned int end);
+
+/**
+ * @brief Whether the processor running the program supports a kernel.
+ */
+bool isSupported(Kernel kernel);
+
+/**
+ * @brief Get the fastest kernel supported by the processor running the program.
+ */
+Kernel bestKernel();
+
+/**
+ * @brief Get the function of a kernel.
+ *
+ * Each kernel is compiled twice: once with the constants of constants.hpp written in the code,
+ * and once reading the constants given at runtime. The first one is returned for the default constants.
+ *
+ * @param constants are the parameters of the membrane equation the function will be called with
+ *
+ * @note The kernel must be supported (see isSupported).
+ */
+MembraneKernel getMembraneKernel(Kernel kernel, const MembraneConstants& constants = getDefaultConstants());
+
+/**
+ * @brief Get the name of a kernel.
+ */
+std::string getName(Kernel kernel);
+
+#endif
@@ -0,0 +1,52 @@
+#include "mapped_file.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+//======================================================================
+//constructeurs/destructeurs
+MappedFile::MappedFile(const string& path)
+: data_(nullptr), size_(0)
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+	
+	struct stat status;
+	if (fstat(fd, &status) == 0 and status.st_size > 0) {
+		void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			data_ = static_cast<const char*>(data);
+			size_ = status.st_size;
+		}
+	}
+	// the mapping stays valid once the file is closed
+	::close(fd);
+}
+//----------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	if (data_ != nullptr) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+}
+//======================================================================
+bool MappedFile::isOpen() const
+{
+	return data_ != nullptr;
+}
+//----------------------------------------------------------------------
+const char* MappedFile::data() const
+{
+	return data_;
+}
+//----------------------------------------------------------------------
+size_t MappedFile::size() const
+{
+	return size_;
+}
+//======================================================================
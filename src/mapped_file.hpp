@@ -0,0 +1,53 @@
+#ifndef mapped_file_H
+#define mapped_file_H
+#include <string>
+#include <cstddef>
+
+/*!
+ * @class MappedFile
+ *
+ * @brief File mapped in memory, read only.
+ *
+ * The pages of the file are only read from the disk when they are accessed.
+ */
+class MappedFile {
+
+public:
+	/**
+	 * @brief Constructor: maps the file in memory.
+	 *
+	 * @param path is the path of the file
+	 */
+	MappedFile(const std::string& path);
+
+	/**
+	 * @brief Destructor: unmaps the file.
+	 */
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * @brief Whether the file is mapped (an empty file is not mapped).
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Get the content of the file.
+	 */
+	const char* data() const;
+
+	/**
+	 * @brief Get the size of the file (bytes).
+	 */
+	size_t size() const;
+
+private:
+
+	const char* data_; //!< Content of the file
+
+	size_t size_; //!< Size of the file (bytes)
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "memory_report.hpp"
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+//======================================================================
+MemoryReport::MemoryReport()
+: transient_(0)
+{}
+//======================================================================
+void MemoryReport::add(const string& name, size_t used, size_t allocated)
+{
+	for (auto& item : items_) {
+		if (item.name == name) {
+			item.used += used;
+			item.allocated += allocated;
+			return;
+		}
+	}
+	items_.push_back({ name, used, allocated });
+}
+//----------------------------------------------------------------------
+void MemoryReport::setTransient(size_t transient)
+{
+	transient_ = transient;
+}
+//======================================================================
+const vector<MemoryItem>& MemoryReport::getItems() const
+{
+	return items_;
+}
+//----------------------------------------------------------------------
+const MemoryItem* MemoryReport::getItem(const string& name) const
+{
+	for (const auto& item : items_) {
+		if (item.name == name) {
+			return &item;
+		}
+	}
+	return nullptr;
+}
+//----------------------------------------------------------------------
+size_t MemoryReport::getUsed() const
+{
+	size_t used(0);
+	for (const auto& item : items_) {
+		used += item.used;
+	}
+	return used;
+}
+//----------------------------------------------------------------------
+size_t MemoryReport::getAllocated() const
+{
+	size_t allocated(0);
+	for (const auto& item : items_) {
+		allocated += item.allocated;
+	}
+	return allocated;
+}
+//----------------------------------------------------------------------
+size_t MemoryReport::getPeak() const
+{
+	return getAllocated() + transient_;
+}
+//======================================================================
+void MemoryReport::write(ostream& out) const
+{
+	ios::fmtflags flags = out.flags();
+	streamsize precision = out.precision(3);
+	const double MB(1 << 20);
+
+	out << left << setw(22) << "structure" << right << setw(14) << "used(MB)" << setw(14) << "allocated(MB)"
+	    << setw(14) << "slack(MB)" << '\n' << fixed;
+	for (const auto& item : items_) {
+		out << left << setw(22) << item.name << right << setw(14) << item.used/MB << setw(14) << item.allocated/MB
+		    << setw(14) << (item.allocated - item.used)/MB << '\n';
+	}
+	out << left << setw(22) << "total" << right << setw(14) << getUsed()/MB << setw(14) << getAllocated()/MB
+	    << setw(14) << (getAllocated() - getUsed())/MB << '\n';
+	out << left << setw(22) << "peak" << right << setw(28) << getPeak()/MB << '\n';
+
+	out.flags(flags);
+	out.precision(precision);
+}
+//======================================================================
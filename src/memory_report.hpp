@@ -0,0 +1,92 @@
+#ifndef memory_report_H
+#define memory_report_H
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+
+/**
+ * @brief Memory of one structure of a network.
+ */
+struct MemoryItem {
+	std::string name; //!< Structure
+	size_t used; //!< Bytes holding data (size of the vectors)
+	size_t allocated; //!< Bytes allocated (capacity of the vectors), slack included
+};
+
+/*!
+ * @class MemoryReport
+ *
+ * @brief Memory of the structures of a network, measured (Network::getMemoryReport) or predicted (Network::planMemory).
+ *
+ * The memory of a structure is the memory it holds from the heap: the capacity of its vectors, so the slack
+ * between their size and their capacity is counted. The peak adds the transient memory needed while the
+ * network is built (the connections are drawn with a copy of their offsets).
+ *
+ * @note The code of the program, the stacks of the threads and the allocator are not counted.
+ */
+class MemoryReport {
+
+public:
+	/**
+	 * @brief Constructor: no structure
+	 */
+	MemoryReport();
+
+	/**
+	 * @brief Add the memory of a structure (to the item of the same name if there is one).
+	 */
+	void add(const std::string& name, size_t used, size_t allocated);
+
+	/**
+	 * @brief Add the memory of a vector.
+	 */
+	template<typename T>
+	void add(const std::string& name, const std::vector<T>& values)
+	{
+		add(name, values.size()*sizeof(T), values.capacity()*sizeof(T));
+	}
+
+	/**
+	 * @brief Set the memory needed only while the network is built, above the memory of its structures.
+	 */
+	void setTransient(size_t transient);
+
+	/**
+	 * @brief Get the structures, in order of their first addition.
+	 */
+	const std::vector<MemoryItem>& getItems() const;
+
+	/**
+	 * @brief Get a structure (nullptr if the report does not have it).
+	 */
+	const MemoryItem* getItem(const std::string& name) const;
+
+	/**
+	 * @brief Get the bytes holding data in all the structures.
+	 */
+	size_t getUsed() const;
+
+	/**
+	 * @brief Get the bytes allocated by all the structures.
+	 */
+	size_t getAllocated() const;
+
+	/**
+	 * @brief Get the peak of the memory: the allocated bytes and the transient memory.
+	 */
+	size_t getPeak() const;
+
+	/**
+	 * @brief Write the table of the structures (MB): used, allocated and slack, then the totals and the peak.
+	 */
+	void write(std::ostream& out) const;
+
+private:
+
+	std::vector<MemoryItem> items_; //!< Structures
+
+	size_t transient_; //!< Memory needed only while the network is built
+};
+
+#endif
@@ -1,50 +1,83 @@
 #include "network.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <limits>
+#include <functional>
 
 using namespace std;
 
 //======================================================================
 //constructeurs/destructeurs
-Network::Network(double networkStopTime, vector<Neuron*> neurons)
-: networkStopTime_(networkStopTime), neurons_(neurons)
+Network::Network(double networkStopTime, vector<Neuron*> neurons, Connectivity connectivity)
+: networkStopTime_(networkStopTime), population_(neurons.size()), neurons_(neurons), connectivity_(connectivity),
+  rates_(0.0, 0.0, numeric_limits<double>::infinity(), parameters_.dt)
 {	
-	index_.resize(getNbNeurons());
+	//Each neuron becomes a view on its entry of the population
+	for (unsigned int i(0); i < neurons_.size(); ++i) {
+		neurons_[i]->attach(&population_, i);
+	}
+	
+	init();
+}
+//----------------------------------------------------------------------
+Network::Network(double networkStopTime, unsigned int nbNeurons, Connectivity connectivity, const Parameters& parameters,
+                 uint64_t seed, const string& outputDirectory)
+: networkStopTime_(networkStopTime), parameters_(parameters), population_(nbNeurons, parameters.getDelaySteps()+1),
+  connectivity_(connectivity), rates_(0.0, 0.0, numeric_limits<double>::infinity(), parameters_.dt)
+{
+	assert(parameters_.isValid());
 	
+	init(seed, outputDirectory);
+}
+//----------------------------------------------------------------------
+void Network::init(uint64_t seed, const string& outputDirectory)
+{
 	nbSpikesTotal_ = 0;
-	writeBox_ = 15;
+	clock_ = 0;
+	checkpointSteps_ = 0;
+	writeBox_ = getDelaySteps();
 	readBox_ = 0;
 	
-	// Random engine for both poisson and uniform
-	std::random_device device;
-	mt19937 generator(device());
-	distributionPoisson = poisson_distribution<unsigned int>(dt*Vext);
+	// Random numbers for both poisson and uniform
+	seed_ = seed;
+	key_ = Philox::key(seed_);
+	setExternalSeed(seed_);
+	
+	// Parameters of Brunel's model: membrane of the neurons, then external frequency
+	population_.setConstants(parameters_.getMembraneConstants());
+	setEta(parameters_.eta);
 	
 	//Neuron type definition
 	if(getNbNeurons() >= 50) {
 		defineTypeNeuron();
+	} else {
+		connectivity_ = Connectivity::Stored;
 	}
 	
 	//Connection
 	connect();
 	
-	//File opening
-	spikesFile_ = new ofstream ("../res/spikes2.txt");
-	if (spikesFile_->fail()) {
-			cerr << "Error opening file " << endl;
-	} else { *spikesFile_ << "dt,spikes" << endl; 
-	}
+	//Serial simulation by default, in windows of the minimal delay
+	windowSteps_ = getDelaySteps();
+	windowSpikes_.assign(getDelaySteps(), vector<unsigned int>());
+	setNbThreads(1);
 	
-	spikesIndexFile_ = new ofstream ("../res/spikes.gdf");
-	if (spikesIndexFile_->fail()) {
+	//File opening, the files are written by the thread of the recorder
+	if (not setOutputDirectory(outputDirectory)) {
 			cerr << "Error opening file " << endl;
 	}
 }
 //----------------------------------------------------------------------
 Network::~Network()
 {
-	//File closing
-	spikesFile_->close();
-	spikesIndexFile_->close();
+	//File closing, once every record is written
+	recorder_.close();
 	
+	for (auto neuron : neurons_) {
+		neuron->detach();
+	}
 }
 //======================================================================
 //getter/setter
@@ -53,48 +86,197 @@ vector<Neuron*> Network::getNeurons() const
 	return neurons_;
 }
 //----------------------------------------------------------------------
+const NeuronPopulation& Network::getPopulation() const
+{
+	return population_;
+}
+//----------------------------------------------------------------------
 unsigned int Network::getNbNeurons() const
 {
-	return neurons_.size();
+	return population_.size();
 }
 //----------------------------------------------------------------------
 // Initialisation of the connected neurons list for each neuron of the network
 // We create Ce = Ne*0.1 excitatory connections and Ci=Ni*0.1 inhibitory connections
 // Ni / Ne = 0.25 according to Brunel's model
-unsigned int Network::getNbExcitatoryConnections()
+unsigned int Network::getNbExcitatoryConnections() const
 {
-	double n = getNbNeurons()*ConnectionPercent*0.8;
+	double n = getNbNeurons()*parameters_.connectionPercent*0.8;
 	unsigned int connections = static_cast<unsigned long>(n);
 	return connections;
 }
 //----------------------------------------------------------------------
-unsigned int Network::getNbInhibitoryConnections()
+unsigned int Network::getNbInhibitoryConnections() const
 {
-	double n = getNbNeurons()*ConnectionPercent*0.2;
+	double n = getNbNeurons()*parameters_.connectionPercent*0.2;
 	unsigned int connections = static_cast<unsigned long>(n);
 	return connections;
 }
 //----------------------------------------------------------------------
-unsigned int Network::getNbExternalConnections()
+unsigned int Network::getNbExternalConnections() const
 {
 	return getNbExcitatoryConnections();
 }
 //----------------------------------------------------------------------
+unsigned int Network::getNbThreads() const
+{
+	return threads_->size();
+}
+//----------------------------------------------------------------------
+void Network::setNbThreads(unsigned int nbThreads)
+{
+	assert(nbThreads > 0);
+	
+	threads_.reset(new ThreadPool(nbThreads));
+	profiler_.setNbThreads(nbThreads);
+	threadSpikes_.assign(nbThreads, vector<vector<unsigned int> >(getDelaySteps()));
+	
+	// each partition contains the same number of blocks of neurons (the last one takes the rest)
+	unsigned int nbBlocks = (getNbNeurons() + BlockSize-1)/BlockSize;
+	partitions_.resize(nbThreads+1);
+	
+	for (unsigned int t(0); t < nbThreads; ++t) {
+		partitions_[t] = min(getNbNeurons(), static_cast<unsigned int>((static_cast<unsigned long>(nbBlocks)*t/nbThreads)*BlockSize));
+	}
+	partitions_[nbThreads] = getNbNeurons();
+}
+//----------------------------------------------------------------------
+unsigned int Network::getWindowSteps() const
+{
+	return windowSteps_;
+}
+//----------------------------------------------------------------------
+void Network::setWindowSteps(unsigned int windowSteps)
+{
+	// a spike must not reach its targets inside the window in which it is emitted
+	assert(windowSteps > 0 and windowSteps <= getDelaySteps());
+	
+	windowSteps_ = windowSteps;
+}
+//----------------------------------------------------------------------
+void Network::setBackpressure(Backpressure backpressure)
+{
+	recorder_.setBackpressure(backpressure);
+}
+//----------------------------------------------------------------------
+const AsyncRecorder& Network::getRecorder() const
+{
+	return recorder_;
+}
+//----------------------------------------------------------------------
+const string& Network::getOutputDirectory() const
+{
+	return outputDirectory_;
+}
+//----------------------------------------------------------------------
+bool Network::setOutputDirectory(const string& directory)
+{
+	// the records of the previous files are all written
+	recorder_.close();
+	outputDirectory_ = directory;
+	
+	if (directory.empty()) {
+		return true;
+	}
+	return recorder_.open(directory + "/spikes.bin", directory + "/spikes2.txt", getNbNeurons(), parameters_.dt);
+}
+//----------------------------------------------------------------------
+const Parameters& Network::getParameters() const
+{
+	return parameters_;
+}
+//----------------------------------------------------------------------
+unsigned int Network::getDelaySteps() const
+{
+	return population_.getNbSlots() - 1;
+}
+//----------------------------------------------------------------------
+double Network::getG() const
+{
+	return parameters_.g;
+}
+//----------------------------------------------------------------------
+void Network::setG(double relativeStrength)
+{
+	parameters_.g = relativeStrength;
+}
+//----------------------------------------------------------------------
+double Network::getEta() const
+{
+	return parameters_.eta;
+}
+//----------------------------------------------------------------------
+void Network::setEta(double eta)
+{
+	parameters_.eta = eta;
+	background_ = PoissonGenerator(parameters_.dt*parameters_.getExternalFrequency());
+}
+//----------------------------------------------------------------------
+bool Network::openSpikeStore(const string& path, double chunkWidth)
+{
+	return recorder_.openStore(path, max(1L, lround(chunkWidth/parameters_.dt)));
+}
+//----------------------------------------------------------------------
+bool Network::openSpikeArchive(const string& path)
+{
+	return recorder_.openArchive(path);
+}
+//----------------------------------------------------------------------
+const SpikeSelection& Network::getSpikeSelection() const
+{
+	return spikeSelection_;
+}
+//----------------------------------------------------------------------
+void Network::setSpikeSelection(const SpikeSelection& selection)
+{
+	spikeSelection_ = selection;
+}
+//----------------------------------------------------------------------
+const RateRecorder& Network::getRates() const
+{
+	return rates_;
+}
+//----------------------------------------------------------------------
+void Network::setRates(const RateRecorder& rates)
+{
+	rates_ = rates;
+}
+//----------------------------------------------------------------------
+Profiler& Network::getProfiler()
+{
+	return profiler_;
+}
+//----------------------------------------------------------------------
+void Network::setKernel(Kernel kernel)
+{
+	population_.setKernel(kernel);
+}
+//----------------------------------------------------------------------
+unsigned int Network::getPartitionBegin(unsigned int t) const
+{
+	return partitions_[t];
+}
+//----------------------------------------------------------------------
 void Network::updateBufferIndex()
 {				
-	if (readBox_+1 > 15) {
+	if (readBox_+1 > getDelaySteps()) {
 		readBox_ = 0;
 	
 	} else { ++readBox_;
 	}
 
-	if (writeBox_+1 > 15) {
+	if (writeBox_+1 > getDelaySteps()) {
 		writeBox_ = 0;
 	
 	} else { ++writeBox_; 
 	}
 }
 //----------------------------------------------------------------------
+unsigned long Network::getClock() const
+{
+	return clock_;
+}
+//----------------------------------------------------------------------
 unsigned int Network::getReadBox() const //necessary for gtest
 {
 	return readBox_;
@@ -107,20 +289,53 @@ void Network::defineTypeNeuron()
 	unsigned int n = getNbNeurons()/5;
 
 	for (unsigned int i(0); i < n; ++i) {
-			neurons_[i]->setIsInhibiter(true);
+			population_.setIsInhibiter(i, true);
 	}
 }
 //======================================================================
 //method connect
 void Network::connect()
 {	
+	//The targets are drawn when the source spikes
+	if (connectivity_ == Connectivity::Procedural) {
+		offsets_.clear();
+		targets_.clear();
+		return;
+	}
+	PROFILE_PHASE(profiler_, Phase::Connect, 0);
+	
+	//Count of the targets of each source: offsets_[i+1] = number of targets of i
+	offsets_.assign(getNbNeurons()+1, 0);
+	
+	//the same random numbers are drawn twice: once to count, once to fill
+	drawConnections([this](unsigned int source, unsigned int) {
+		++offsets_[source+1];
+	});
+	
+	//offsets_[i] = first target of i
+	for (unsigned int i(0); i < getNbNeurons(); ++i) {
+		offsets_[i+1] += offsets_[i];
+	}
+	
+	//Fill of the targets of each source
+	//the connections are drawn target by target, so that the targets of each source are sorted
+	targets_.assign(offsets_.back(), 0);
+	vector<size_t> next(offsets_.begin(), offsets_.end()-1);
+	
+	drawConnections([this, &next](unsigned int source, unsigned int target) {
+		targets_[next[source]++] = target;
+	});
+}
+//----------------------------------------------------------------------
+void Network::drawConnections(const function<void(unsigned int, unsigned int)>& connection)
+{
 	//First method connect for test_twoneurons and google test
 	if (getNbNeurons() < 50) {
 		
-		for (unsigned int i(0); i < getNbNeurons(); ++i) {
-			for (unsigned int j(0); j < getNbNeurons(); ++j) {
+		for (unsigned int j(0); j < getNbNeurons(); ++j) {
+			for (unsigned int i(0); i < getNbNeurons(); ++i) {
 				if (i != j) {
-					index_[i].push_back(j);
+					connection(i, j);
 				}
 			}
 		}
@@ -132,97 +347,478 @@ void Network::connect()
 			
 		for (unsigned int i(0); i < getNbNeurons(); ++i) {
 			for (unsigned int k(0); k < getNbInhibitoryConnections(); ++k) {
-				index_[uniform(nbInhibitory)].push_back(i);
+				connection(uniform(nbInhibitory, i, k), i);
 			}
 			for (unsigned int j(0); j < getNbExcitatoryConnections(); ++j) {
-				index_[uniform(nbExcitatory) + nbInhibitory].push_back(i);
+				connection(uniform(nbExcitatory, i, getNbInhibitoryConnections() + j) + nbInhibitory, i);
 			}
 		}
 		
 	}
 }
+//----------------------------------------------------------------------
+void Network::drawTargets(unsigned int source, unsigned int begin, unsigned int end, vector<unsigned int>& targets) const
+{
+	assert(begin % BlockSize == 0);
+	
+	// number of targets of each source neuron
+	unsigned long nbTargets = getNbExcitatoryConnections() + getNbInhibitoryConnections();
+	
+	targets.clear();
+	
+	for (unsigned int block(begin/BlockSize); block*BlockSize < end; ++block) {
+		unsigned int first = block*BlockSize;
+		unsigned int last = min(first + BlockSize, getNbNeurons());
+		
+		// the block receives its share of the targets of the source
+		unsigned int nbBlockTargets = nbTargets*last/getNbNeurons() - nbTargets*first/getNbNeurons();
+		
+		Philox::Counter random;
+		for (unsigned int k(0); k < nbBlockTargets; ++k) {
+			if (k % 4 == 0) {
+				random = Philox::generate({{source, block, k/4, ProceduralStream}}, key_);
+			}
+			targets.push_back(first + Philox::toIndex(random[k % 4], last - first));
+		}
+	}
+}
+//----------------------------------------------------------------------
+Connectivity Network::getConnectivity() const
+{
+	return connectivity_;
+}
+//----------------------------------------------------------------------
+unsigned int Network::getNbTargets(unsigned int source) const
+{
+	if (connectivity_ == Connectivity::Procedural) {
+		return getNbExcitatoryConnections() + getNbInhibitoryConnections();
+	}
+	return offsets_[source+1] - offsets_[source];
+}
+//----------------------------------------------------------------------
+const unsigned int* Network::getTargets(unsigned int source) const
+{
+	assert(connectivity_ == Connectivity::Stored);
+	return targets_.data() + offsets_[source];
+}
+//----------------------------------------------------------------------
+size_t Network::getNbConnections() const
+{
+	if (connectivity_ == Connectivity::Procedural) {
+		return static_cast<size_t>(getNbNeurons())*getNbTargets(0);
+	}
+	return targets_.size();
+}
+//----------------------------------------------------------------------
+MemoryReport Network::getMemoryReport() const
+{
+	MemoryReport report;
+	report.add("connections", offsets_);
+	report.add("connections", targets_);
+	population_.reportMemory(report);
+	
+	report.add("spike lists", windowSpikes_);
+	for (const auto& spikes : windowSpikes_) {
+		report.add("spike lists", spikes);
+	}
+	report.add("spike lists", threadSpikes_);
+	for (const auto& thread : threadSpikes_) {
+		report.add("spike lists", thread);
+		for (const auto& spikes : thread) {
+			report.add("spike lists", spikes);
+		}
+	}
+	report.add("spike lists", selectedSpikes_);
+	
+	recorder_.reportMemory(report);
+	rates_.reportMemory(report);
+	report.add("random numbers", sizeof(key_) + sizeof(externalKey_), sizeof(key_) + sizeof(externalKey_));
+	background_.reportMemory(report);
+	profiler_.reportMemory(report);
+	return report;
+}
+//----------------------------------------------------------------------
+//Capacity of a vector grown one element at a time
+static size_t getGrownCapacity(size_t size)
+{
+	size_t capacity(size > 0);
+	while (capacity < size) {
+		capacity *= 2;
+	}
+	return capacity;
+}
+//----------------------------------------------------------------------
+MemoryReport Network::planMemory(unsigned int nbNeurons, Connectivity connectivity, const Parameters& parameters,
+                                 unsigned int nbThreads, double stopTime, double binWidth)
+{
+	MemoryReport report;
+	size_t n = nbNeurons;
+	size_t delaySteps = parameters.getDelaySteps();
+	
+	// stored connections: each neuron receives ConnectionPercent of the excitatory and of the inhibitory neurons
+	// (same counts as getNbExcitatoryConnections and getNbInhibitoryConnections)
+	if (connectivity == Connectivity::Stored) {
+		size_t excitatory = static_cast<unsigned long>(n*parameters.connectionPercent*0.8);
+		size_t inhibitory = static_cast<unsigned long>(n*parameters.connectionPercent*0.2);
+		size_t connections = (n + 1)*sizeof(size_t) + n*(excitatory + inhibitory)*sizeof(unsigned int);
+		report.add("connections", connections, connections);
+		report.setTransient(n*sizeof(size_t));
+	}
+	
+	// same vectors as NeuronPopulation: potential, refractory time, external current, spikes, mask and type
+	size_t neurons = n*(sizeof(double) + sizeof(int) + sizeof(double) + sizeof(unsigned int) + sizeof(unsigned char))
+	                 + (n + 63)/64*sizeof(uint64_t);
+	size_t ring = n*(delaySteps + 1)*sizeof(double);
+	report.add("neurons", neurons, neurons);
+	report.add("delay ring", ring, ring);
+	
+	// all the neurons may spike in the same step (synchronous regime): a list of a thread grows one spike at a time up
+	// to its partition (same bounds as setNbThreads), the list of the step merges them by ranges and may reach twice n,
+	// and the selection grows up to n
+	size_t nbBlocks = (n + BlockSize-1)/BlockSize;
+	size_t spikeLists = (1 + nbThreads)*delaySteps*sizeof(vector<unsigned int>) + nbThreads*sizeof(vector<vector<unsigned int> >)
+	                    + delaySteps*2*n*sizeof(unsigned int) + getGrownCapacity(n)*sizeof(unsigned int);
+	for (unsigned int t(0); t < nbThreads; ++t) {
+		size_t begin = min(n, nbBlocks*t/nbThreads*BlockSize);
+		size_t end = (t + 1 < nbThreads) ? min(n, nbBlocks*(t + 1)/nbThreads*BlockSize) : n;
+		spikeLists += delaySteps*getGrownCapacity(end - begin)*sizeof(unsigned int);
+	}
+	report.add("spike lists", spikeLists, spikeLists);
+	
+	size_t blocks = AsyncRecorder::getBlockMemory();
+	report.add("recorder blocks", blocks, blocks);
+	
+	// bins of whole steps as in RateRecorder (one step for the rates of Network), excitatory and inhibitory
+	size_t binSteps = max(1L, lround(binWidth/parameters.dt));
+	size_t nbBins = (static_cast<size_t>(ceil(stopTime/parameters.dt)) + binSteps-1)/binSteps;
+	report.add("rates", 2*nbBins*sizeof(uint32_t), 2*getGrownCapacity(nbBins)*sizeof(uint32_t));
+	
+	// the keys and the table of the distribution of the external spikes
+	PoissonGenerator background(parameters.dt*parameters.getExternalFrequency());
+	report.add("random numbers", 2*sizeof(Philox::Key), 2*sizeof(Philox::Key));
+	background.reportMemory(report);
+	
+	// at most one event per phase, thread and window
+	size_t nbEvents = NbPhases*static_cast<size_t>(ceil(stopTime/(parameters.dt*delaySteps)));
+	size_t profiler = Profiler::getMemory(nbThreads, Profiler::Enabled ? getGrownCapacity(nbEvents) : 0);
+	report.add("profiler", profiler, profiler);
+	return report;
+}
 //======================================================================
 //Poisson distribution of randomly external spike
-unsigned int Network::poisson()
+unsigned int Network::poisson(unsigned int neuron, unsigned long step) const
 {
-	return distributionPoisson(generator);
+	return background_.draw(externalKey_, PoissonStream, neuron, step);
 }
 //----------------------------------------------------------------------
 //To generate the connection we need uniformly distributed random numbers
-unsigned int Network::uniform(unsigned int size)
+unsigned int Network::uniform(unsigned int size, unsigned int target, unsigned int k) const
+{
+	uint32_t random = Philox::generate({{target, k/4, 0, ConnectionStream}}, key_)[k % 4];
+	return Philox::toIndex(random, size);
+}
+//----------------------------------------------------------------------
+uint64_t Network::getSeed() const
+{
+	return seed_;
+}
+//----------------------------------------------------------------------
+void Network::setSeed(uint64_t seed)
+{
+	seed_ = seed;
+	key_ = Philox::key(seed_);
+	setExternalSeed(seed);
+	connect();
+}
+//----------------------------------------------------------------------
+uint64_t Network::getExternalSeed() const
+{
+	return externalSeed_;
+}
+//----------------------------------------------------------------------
+void Network::setExternalSeed(uint64_t seed)
+{
+	externalSeed_ = seed;
+	externalKey_ = Philox::key(externalSeed_);
+}
+//======================================================================
+//transmission of the spikes to the targets of [begin, end)
+void Network::deliverSpikes(const vector<unsigned int>& spikes, unsigned int writeBox, unsigned int begin, unsigned int end)
+{
+	if (connectivity_ == Connectivity::Procedural) {
+		deliverProceduralSpikes(spikes, writeBox, begin, end);
+		return;
+	}
+	
+	double* slot = population_.slot(writeBox);
+	
+	for (auto i : spikes) {
+		
+		// If the source neuron is inhibitatory, the neuron receives a negative spike
+		// if the source neuron is excitatory, the neuron receives a positive spike
+		double spike = population_.isInhibiter(i) ? -parameters_.g : 1.0;
+		
+		// the targets are sorted: the targets of the partition are contiguous
+		const unsigned int* first = lower_bound(getTargets(i), getTargets(i+1), begin);
+		const unsigned int* last = lower_bound(first, getTargets(i+1), end);
+		
+		for (const unsigned int* target = first; target != last; ++target) {
+			slot[*target] += spike;
+		}
+	}
+}
+//----------------------------------------------------------------------
+void Network::deliverProceduralSpikes(const vector<unsigned int>& spikes, unsigned int writeBox, unsigned int begin, unsigned int end)
 {
-	uniform_int_distribution<unsigned int> distributionUniform(0,size-1);
-	return distributionUniform(generator);
+	double* slot = population_.slot(writeBox);
+	vector<unsigned int> targets;
+	
+	for (auto i : spikes) {
+		double spike = population_.isInhibiter(i) ? -parameters_.g : 1.0;
+		
+		// the targets of the partition are drawn again
+		drawTargets(i, begin, end, targets);
+		
+		for (auto target : targets) {
+			slot[target] += spike;
+		}
+	}
 }
 //======================================================================
 void Network::writeSpikeToFile() // for gnuplot
 {	
-	*spikesFile_ << clock_*dt << " " << nbSpikesTotal_ << endl;
+	recorder_.recordTotal(clock_, nbSpikesTotal_);
 }
 //======================================================================
 //update du network
 void Network::update()
 {
 	// Conversion of the netork stop time (ms) in time step
-	unsigned int networkStopTime = static_cast<unsigned long>(floor(networkStopTime_/dt));
+	unsigned long networkStopTime = static_cast<unsigned long>(floor(networkStopTime_/parameters_.dt));
+	
+	unsigned long nextCheckpoint = clock_ + checkpointSteps_;
 	
 	while(clock_ < networkStopTime)	{
+		// the last window stops with the simulation
+		simulateWindow(static_cast<unsigned int>(min<unsigned long>(windowSteps_, networkStopTime - clock_)));
 		
-		//for each neuron of the network
-		for (unsigned int i(0); i < index_.size(); ++i) {
+		// periodic snapshot, between two windows
+		if (not checkpointPath_.empty() and clock_ >= nextCheckpoint) {
+			PROFILE_PHASE(profiler_, Phase::Checkpoint, 0);
+			if (not save(checkpointPath_)) {
+				cerr << "Error opening file " << endl;
+			}
+			nextCheckpoint = clock_ + checkpointSteps_;
+		}
+	}
+	
+	PROFILE_PHASE(profiler_, Phase::Output, 0);
+	
+	// the last snapshot is the end of the simulation, from which a longer simulation can continue
+	if (not checkpointPath_.empty() and not save(checkpointPath_)) {
+		cerr << "Error opening file " << endl;
+	}
+	
+	// the files are complete at the end of the simulation
+	recorder_.flush();
+	if (not outputDirectory_.empty() and not rates_.writeCSV(outputDirectory_ + "/rates.csv")) {
+		cerr << "Error opening file " << endl;
+	}
+}
+//----------------------------------------------------------------------
+void Network::simulateWindow(unsigned int nbSteps)
+{
+	profiler_.nextWindow();
+	
+	//update the potential and state of each neuron of the population for the whole window
+	//returns once every thread has updated its partition
+	threads_->run([this, nbSteps](unsigned int t) { updatePartition(t, nbSteps); });
+	
+	//the spikes of each step of the window, in order of the neurons
+	{
+		PROFILE_PHASE(profiler_, Phase::Gather, 0);
+		for (unsigned int s(0); s < nbSteps; ++s) {
+			windowSpikes_[s].clear();
+			for (const auto& spikes : threadSpikes_) {
+				windowSpikes_[s].insert(windowSpikes_[s].end(), spikes[s].begin(), spikes[s].end());
+			}
+		}
+	}
+	
+	//transmission of the spikes of the window to the connected neurons, in one exchange
+	//each thread writes only into its own partition of targets
+	threads_->run([this, nbSteps](unsigned int t) {
+		PROFILE_PHASE(profiler_, Phase::Delivery, t);
+		for (unsigned int s(0); s < nbSteps; ++s) {
+			deliverSpikes(windowSpikes_[s], (writeBox_ + s) % population_.getNbSlots(), partitions_[t], partitions_[t+1]);
+		}
+	});
+	
+	PROFILE_PHASE(profiler_, Phase::Record, 0);
+	for (unsigned int s(0); s < nbSteps; ++s) {
+		nbSpikesTotal_ = windowSpikes_[s].size();
+		
+		// record of spikes in the binary spike file: If the neuron has spiked during this dt, 
+		//the step and the index of the neuron are recorded
+		if (spikeSelection_.selectsAll()) {
+			recorder_.recordSpikes(clock_, windowSpikes_[s]);
+		} else if (spikeSelection_.isRecorded(clock_)) {
+			spikeSelection_.select(clock_, windowSpikes_[s], selectedSpikes_);
+			recorder_.recordSpikes(clock_, selectedSpikes_);
+		}
+		rates_.record(clock_, windowSpikes_[s], population_);
+		
+		// update of the buffer indexes
+		updateBufferIndex();
+		
+		// record of total number of spikes per dt in the Gnuplot file
+		writeSpikeToFile();
+		nbSpikesTotal_ = 0;
+		
+		//step time incrementation
+		clock_ += h;
+	}
+}
+//----------------------------------------------------------------------
+void Network::updatePartition(unsigned int t, unsigned int nbSteps)
+{
+	PROFILE_PHASE(profiler_, Phase::Update, t);
+	unsigned int nbSlots = population_.getNbSlots();
+	
+	for (unsigned int s(0); s < nbSteps; ++s) {
+		threadSpikes_[t][s].clear();
+	}
+	
+	// The neurons of a chunk go through the whole window while they are in cache
+	for (unsigned int begin(partitions_[t]); begin < partitions_[t+1]; begin += WindowBlockSize) {
+		unsigned int end = min(begin + WindowBlockSize, partitions_[t+1]);
+		
+		for (unsigned int s(0); s < nbSteps; ++s) {
+			unsigned int readBox = (readBox_ + s) % nbSlots;
 			
-			//update the potential and state of the neuron
-			neurons_[i]->update(readBox_);			
+			// The buffer index just read is emptied by the thread that owns the neurons
+			{
+				PROFILE_PHASE(profiler_, Phase::Membrane, t);
+				population_.update(begin, end, readBox);
+				population_.clearSlot(readBox, begin, end);
+			}
 			
-			// Condition made to preserve the first gtests that do not take account of random spikes		
+			// Condition made to preserve the first gtests that do not take account of random spikes
 			if (getNbNeurons() >= 50) {
-			
-				//randomly distributed external spike from outside network
-				unsigned int backgroundNoise(poisson());
+				PROFILE_PHASE(profiler_, Phase::External, t);
 				
+				//randomly distributed external spike from outside network, drawn for the whole chunk
 				// If the poisson process activates the external synapses
 				// Then for each external synapses activated (random) a spikes is distributed to the neuron
-				neurons_[i]->fillBuffer(backgroundNoise, writeBox_);
-			}		
-
-
-			// If the source neuron spikes, the neuron receives a spikes
-			if (neurons_[i]->hasSpike()) {	
-						
-				// record of spikes in the Jupyter file: If the neuron has spiked during this dt, 
-				//the spike and the index of the neuron is recorded in a file
-				++nbSpikesTotal_;
-				*spikesIndexFile_ << clock_ << "\t" << i+1 << endl;
-	
-				for (unsigned int j(0); j < index_[i].size(); ++j) {
-	
-					// If the source neuron is inhibitatory, the neuron receives a negative spike
-					if (neurons_[i]->isInhibiter()) {
-
-						neurons_[index_[i][j]]->fillBuffer(-g, writeBox_);
-					
-					//if the source neuron is excitatory, the neuron receives a positive spike
-					} else {
-						
-						neurons_[index_[i][j]]->fillBuffer(1, writeBox_);
-					}
-				}			
+				background_.fill(externalKey_, PoissonStream, clock_ + s, begin, end, population_.slot((writeBox_ + s) % nbSlots));
 			}
 			
-			// Emptying of buffer index just read
-			neurons_[i]->buffer_[readBox_] = 0.0;
+			// compaction of the spike mask of the chunk into the list of its spikes
+			{
+				PROFILE_PHASE(profiler_, Phase::Collect, t);
+				population_.collectSpikes(begin, end, threadSpikes_[t][s]);
+			}
+		}
+	}
+}
+//======================================================================
+//Snapshot
+bool Network::save(const string& path) const
+{
+	// written aside then renamed: a run stopped during the save keeps the previous snapshot
+	string temporary = path + ".tmp";
+	{
+		ofstream file(temporary, ios::binary | ios::trunc);
+		if (file.fail()) {
+			return false;
 		}
 		
-		// update of the buffer indexes
-		updateBufferIndex();
-	
-	// record of total number of spikes per dt in the Gnuplot file
-	writeSpikeToFile();
-	nbSpikesTotal_ = 0;
+		SnapshotHeader header;
+		memcpy(header.magic, "BRCK", 4);
+		header.version = SnapshotVersion;
+		header.nbNeurons = getNbNeurons();
+		header.nbSlots = population_.getNbSlots();
+		header.clock = clock_;
+		header.seed = seed_;
+		header.externalSeed = externalSeed_;
+		header.readBox = readBox_;
+		header.writeBox = writeBox_;
+		header.connectivity = connectivity_ == Connectivity::Procedural ? 1 : 0;
+		header.reserved = 0;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(&parameters_), sizeof(parameters_));
 		
-	//step time incrementation
-	clock_ += h;	
+		population_.save(file);
+		writeArray(file, offsets_);
+		writeArray(file, targets_);
 		
+		if (not file.flush()) {
+			return false;
+		}
 	}
+	return rename(temporary.c_str(), path.c_str()) == 0;
+}
+//----------------------------------------------------------------------
+bool Network::restore(const string& path)
+{
+	ifstream file(path, ios::binary);
+	
+	SnapshotHeader header;
+	if (not file.read(reinterpret_cast<char*>(&header), sizeof(header))
+	    or memcmp(header.magic, "BRCK", 4) != 0 or header.version != SnapshotVersion
+	    or header.nbNeurons != getNbNeurons() or header.nbSlots != population_.getNbSlots()
+	    or header.readBox >= header.nbSlots or header.writeBox >= header.nbSlots or header.connectivity > 1) {
+		return false;
+	}
+	
+	// the simulation continues with the parameters of the snapshot, at the same step time
+	Parameters parameters;
+	if (not file.read(reinterpret_cast<char*>(&parameters), sizeof(parameters)) or not parameters.isValid()
+	    or parameters.dt != parameters_.dt or parameters.getDelaySteps() != getDelaySteps()) {
+		return false;
+	}
+	
+	// the state is read aside: the network is only changed if the whole snapshot is valid
+	NeuronPopulation state(getNbNeurons(), population_.getNbSlots());
+	vector<size_t> offsets;
+	vector<unsigned int> targets;
+	if (not state.restore(file) or not readArray(file, offsets, getNbNeurons() + 1) or not readArray(file, targets)) {
+		return false;
+	}
+	
+	// the stored connections only reach neurons of the network, the procedural ones are not stored
+	if (header.connectivity == 0) {
+		if (offsets.size() != getNbNeurons() + 1 or offsets.front() != 0 or offsets.back() != targets.size()
+		    or adjacent_find(offsets.begin(), offsets.end(), greater<size_t>()) != offsets.end()
+		    or any_of(targets.begin(), targets.end(), [this](unsigned int target) { return target >= getNbNeurons(); })) {
+			return false;
+		}
+	} else if (not offsets.empty() or not targets.empty()) {
+		return false;
+	}
+	
+	// the neurons keep their kernel
+	state.setConstants(parameters.getMembraneConstants());
+	state.setKernel(population_.getKernel());
+	population_ = move(state);
+	
+	offsets_.swap(offsets);
+	targets_.swap(targets);
+	connectivity_ = header.connectivity == 1 ? Connectivity::Procedural : Connectivity::Stored;
+	seed_ = header.seed;
+	key_ = Philox::key(seed_);
+	setExternalSeed(header.externalSeed);
+	parameters_ = parameters;
+	setEta(parameters_.eta);
+	clock_ = header.clock;
+	readBox_ = header.readBox;
+	writeBox_ = header.writeBox;
+	return true;
+}
+//----------------------------------------------------------------------
+void Network::setCheckpoint(const string& path, double interval)
+{
+	checkpointPath_ = path;
+	checkpointSteps_ = max(1L, lround(interval/parameters_.dt));
 }
 //======================================================================
@@ -5,10 +5,32 @@
 #include <vector>
 #include <list>
 #include <fstream>
-#include <random>
+#include <cstdint>
+#include <memory>
+#include <functional>
 #include "neuron.hpp"
+#include "population.hpp"
+#include "thread_pool.hpp"
+#include "random.hpp"
+#include "poisson.hpp"
+#include "async_recorder.hpp"
+#include "rate_recorder.hpp"
+#include "spike_selection.hpp"
+#include "parameters.hpp"
+#include "profiler.hpp"
+#include "memory_report.hpp"
 
 
+/**
+ * @brief Storage of the connections of the network.
+ * 
+ * Stored: the targets of each neuron are drawn once and stored (memory grows with N*N).
+ * Procedural: the targets of a neuron are drawn again each time it spikes, from a counter-based
+ * random generator keyed by the seed of the network and the source neuron, so the same targets are always drawn
+ * (memory grows with N).
+ */
+enum class Connectivity { Stored, Procedural };
+
 /*! 
  * @class Network
  * 
@@ -26,25 +48,60 @@
 class Network {
 
 public:
+	static const uint64_t DefaultSeed = 2017; //!< Seed used when none is given
+	
+	/**
+	 * @brief Streams of the counter-based generator
+	 * 
+	 * The last word of the counter of the generator identifies what the random numbers are used for.
+	 */
+	enum Stream : uint32_t { ConnectionStream = 1, ProceduralStream = 2, PoissonStream = 3 };
+	
 	/**
 	 * @brief Constructor
 	 * 
 	 * @param networkStopTime determine the end time of the simulation
 	 * @param neurons is the list of local neurons connected
+	 * @param connectivity is the storage of the connections. Default value = stored
+	 */
+	Network(double networkStopTime, std::vector<Neuron*> neurons, Connectivity connectivity = Connectivity::Stored);
+	
+	/**
+	 * @brief Constructor
+	 * 
+	 * The neurons are directly created inside the population of the network, without Neuron objects.
+	 * 
+	 * @param networkStopTime determine the end time of the simulation
+	 * @param nbNeurons is the number of neurons of the network
+	 * @param connectivity is the storage of the connections. Default value = stored
+	 * @param parameters are the parameters of the model (they must be valid). Default value = constants of constants.hpp
+	 * @param seed is the seed of the random numbers (see setSeed). Default value = DefaultSeed
+	 * @param outputDirectory is the directory of the files of the simulation (see setOutputDirectory). Default value = "../res"
+	 * 
+	 * @note The procedural connectivity is only used for networks of at least 50 neurons.
 	 */
-	Network(double networkStopTime, std::vector<Neuron*> neurons);
+	Network(double networkStopTime, unsigned int nbNeurons, Connectivity connectivity = Connectivity::Stored,
+	        const Parameters& parameters = Parameters(), uint64_t seed = DefaultSeed, const std::string& outputDirectory = "../res");
 	
 	/**
 	 * @brief Destructor
+	 * 
+	 * @note The Neuron views are detached: they keep the state they had at the end of the simulation.
 	 */
 	~Network();
 	
 	/**
 	 * @brief Get neurons
 	 * 
+	 * @return the Neuron views given to the constructor (empty if the network was built from a number of neurons)
 	 */
 	 std::vector<Neuron*> getNeurons() const;
 	
+	/**
+	 * @brief Get the population of the network.
+	 */
+	const NeuronPopulation& getPopulation() const;
+	
 	/**
 	 * @brief Get the number of neurons inside the network.
 	 */
@@ -55,21 +112,152 @@ public:
 	 * 
 	 * @return an integer
 	 */
-	unsigned int getNbExcitatoryConnections();
+	unsigned int getNbExcitatoryConnections() const;
 	
 	/**
 	 * @brief Get th number of inhibitory connections
 	 *
 	 * @return an integer
 	 */
-	unsigned int getNbInhibitoryConnections();
+	unsigned int getNbInhibitoryConnections() const;
 	
 	/**
 	 * @brief Get the number of external connections
 	 * 
 	 * @return an integer
 	 */
-	unsigned int getNbExternalConnections();
+	unsigned int getNbExternalConnections() const;
+	
+	/**
+	 * @brief Get the number of threads updating the neurons.
+	 */
+	unsigned int getNbThreads() const;
+	
+	/**
+	 * @brief Set the number of threads updating the neurons.
+	 * 
+	 * The neurons are split into nbThreads contiguous partitions, updated in parallel at each step.
+	 * 
+	 * @param nbThreads is the number of threads (1 for the serial simulation)
+	 */
+	void setNbThreads(unsigned int nbThreads);
+	
+	/**
+	 * @brief Get the number of steps simulated between two exchanges of spikes.
+	 */
+	unsigned int getWindowSteps() const;
+	
+	/**
+	 * @brief Set the number of steps simulated between two exchanges of spikes.
+	 * 
+	 * A spike reaches its targets DelayStep steps after it is emitted: during a window of at most DelayStep steps,
+	 * the neurons only receive spikes emitted before the window. Each thread then advances its neurons through
+	 * the whole window, chunk after chunk (the state of a chunk stays in cache), and the spikes of the window are
+	 * transmitted all at once at its end. The threads synchronize once per window instead of once per step.
+	 * The simulation is exactly the same whatever the number of steps of the window.
+	 * 
+	 * @param windowSteps is the number of steps of the window, from 1 (exchange at each step) to DelayStep (default)
+	 */
+	void setWindowSteps(unsigned int windowSteps);
+	
+	/**
+	 * @brief Set the behaviour of the recorder when its writer thread is late (see AsyncRecorder).
+	 */
+	void setBackpressure(Backpressure backpressure);
+	
+	/**
+	 * @brief Get the recorder of the spikes (files and counters of dropped records).
+	 */
+	const AsyncRecorder& getRecorder() const;
+	
+	/**
+	 * @brief Get the directory of the files of the simulation ("../res" by default, empty if there is no file).
+	 */
+	const std::string& getOutputDirectory() const;
+	
+	/**
+	 * @brief Write the files of the simulation (spikes.bin, spikes2.txt, rates.csv) in another directory.
+	 * 
+	 * The current files are completed and closed, then the files are created in directory.
+	 * 
+	 * @param directory is the directory of the files (it must exist), or empty for no file at all
+	 * 
+	 * @return whether the files could be opened
+	 */
+	bool setOutputDirectory(const std::string& directory);
+	
+	/**
+	 * @brief Also record the spikes in a spike store, indexed by time and neuron for the range queries (see SpikeStore).
+	 * 
+	 * @param path is the path of the store. Default value = "../res/spikes.store"
+	 * @param chunkWidth is the time window of a chunk of the store (ms). Default value = 100 ms
+	 * 
+	 * @return whether the store could be opened
+	 * 
+	 * @note The store is complete once the network is destroyed. It contains the spikes selected (see setSpikeSelection).
+	 */
+	bool openSpikeStore(const std::string& path = "../res/spikes.store", double chunkWidth = 100.0);
+	
+	/**
+	 * @brief Also record the spikes in a compressed spike archive (see SpikeArchive).
+	 * 
+	 * @param path is the path of the archive. Default value = "../res/spikes.spkz"
+	 * 
+	 * @return whether the archive could be opened
+	 * 
+	 * @note The archive is complete once the network is destroyed. It contains the spikes selected (see setSpikeSelection).
+	 */
+	bool openSpikeArchive(const std::string& path = "../res/spikes.spkz");
+	
+	/**
+	 * @brief Get the selection of the spikes recorded in the file "spikes.bin".
+	 */
+	const SpikeSelection& getSpikeSelection() const;
+	
+	/**
+	 * @brief Set the selection of the spikes recorded in the file "spikes.bin" (every spike by default).
+	 * 
+	 * @note The totals per step ("spikes2.txt") and the rates ("rates.csv") still count every spike.
+	 */
+	void setSpikeSelection(const SpikeSelection& selection);
+	
+	/**
+	 * @brief Get the spikes of the excitatory and inhibitory neurons counted in bins of time.
+	 */
+	const RateRecorder& getRates() const;
+	
+	/**
+	 * @brief Set the bins of time in which the spikes are counted (one bin per step by default).
+	 * 
+	 * @param rates is an empty recorder giving the width of the bins and the time window
+	 * 
+	 * @note The bins are written in the file "rates.csv" at the end of the simulation.
+	 */
+	void setRates(const RateRecorder& rates);
+	
+	/**
+	 * @brief Get the time spent in each phase of the simulation, per window and per thread.
+	 * 
+	 * @note The profiler stays empty unless the simulation is compiled with NEURON_PROFILE (see profiler.hpp).
+	 */
+	Profiler& getProfiler();
+	
+	/**
+	 * @brief Set the kernel updating the neurons (see NeuronPopulation::setKernel).
+	 */
+	void setKernel(Kernel kernel);
+	
+	/**
+	 * @brief Get the first neuron of the partition of thread t.
+	 * 
+	 * @note The partition of thread t is [getPartitionBegin(t), getPartitionBegin(t+1)).
+	 */
+	unsigned int getPartitionBegin(unsigned int t) const;
+	
+	/**
+	 * @brief Get the global clock of the simulation (in step time).
+	 */
+	unsigned long getClock() const;
 	
 	/**
 	 * @brief Get the index of the buffer in which the spikes are read.
@@ -81,24 +269,91 @@ public:
 	 */
 	void writeSpikeToFile();
 	
+	/**
+	 * @brief Get the seed of the random numbers of the network.
+	 */
+	uint64_t getSeed() const;
+	
+	/**
+	 * @brief Set the seed of the random numbers of the network.
+	 * 
+	 * The random numbers (connections and external spikes) are drawn from a counter-based generator
+	 * keyed by the seed: they only depend on the seed, the neuron and the step time, not on the order
+	 * in which they are drawn. A simulation is then reproducible whatever the number of threads.
+	 * 
+	 * @param seed is the new seed
+	 * 
+	 * @note The connections are drawn again.
+	 */
+	void setSeed(uint64_t seed);
+	
+	/**
+	 * @brief Get the seed of the external spikes.
+	 */
+	uint64_t getExternalSeed() const;
+	
+	/**
+	 * @brief Set the seed of the external spikes only, the connections are kept.
+	 * 
+	 * @note setSeed sets the seed of both the connections and the external spikes.
+	 */
+	void setExternalSeed(uint64_t seed);
+	
+	/**
+	 * @brief Get the parameters of the model.
+	 */
+	const Parameters& getParameters() const;
+	
+	/**
+	 * @brief Get the transmission delay in steps (DelayStep for the default parameters).
+	 */
+	unsigned int getDelaySteps() const;
+	
+	/**
+	 * @brief Get the relative strength of the inhibitory synapses (g of constants.hpp by default).
+	 */
+	double getG() const;
+	
+	/**
+	 * @brief Set the relative strength of the inhibitory synapses.
+	 */
+	void setG(double relativeStrength);
+	
+	/**
+	 * @brief Get Eta, the external frequency relative to the threshold frequency (Eta of constants.hpp by default).
+	 */
+	double getEta() const;
+	
+	/**
+	 * @brief Set Eta, the external frequency relative to the threshold frequency.
+	 */
+	void setEta(double eta);
+	
 	/**
 	 * @brief Poisson distribution of external Spike
 	 * 
+	 * The numbers of external spikes of any step can be drawn directly, without drawing the previous steps.
+	 * 
+	 * @note During the simulation, the external spikes of a whole partition are drawn in bulk (see PoissonGenerator::fill).
+	 * 
+	 * @param neuron is the neuron receiving the external spikes
+	 * @param step is the step time of the external spikes
+	 * 
 	 * @return a random integer that will define the number of external spike receive
 	 */ 
-	unsigned int poisson();
+	unsigned int poisson(unsigned int neuron, unsigned long step) const;
 	
 	/**
 	 * @brief Uniform distribution of connection
+	 * 
+	 * @param size is the number of possible sources
+	 * @param target is the target neuron of the connection
+	 * @param k is the number of the connection of the target
+	 * 
+	 * @return a random integer of [0, size)
 	 */ 
-	unsigned int uniform(unsigned int size);
+	unsigned int uniform(unsigned int size, unsigned int target, unsigned int k) const;
 	
-	/**
-	 * @brief Define whether the neuron is excitatory or inhibitory.
-	 * 
-	 * There are Ne excitatory neurons and Ni inhibitory neurons integrate and fire neurons
-	 */
-	 
 	/**
 	 * @brief update the index readBox and writeBox
 	 */
@@ -119,65 +374,274 @@ public:
 	 * Each neuron receives randomly chosen connections. 
 	 * To generate the connection we need uniformly distributed random numbers.
 	 * @note One neuron can connect several times to the same neuron and it can connect to itself.
+	 * With the procedural connectivity, the targets are only drawn when the source spikes (see drawTargets).
+	 * The connections are stored as a compressed sparse row matrix, built in two passes:
+	 * the targets of each source are first counted, then filled. The targets of each source are sorted.
 	 */
 	void connect();
 	
+	/**
+	 * @brief Get the storage of the connections.
+	 */
+	Connectivity getConnectivity() const;
+	
+	/**
+	 * @brief Get the number of targets of a source neuron.
+	 */
+	unsigned int getNbTargets(unsigned int source) const;
+	
+	/**
+	 * @brief Get the targets of a source neuron.
+	 * 
+	 * @return pointer to the getNbTargets(source) sorted targets of source
+	 * 
+	 * @note Only for the stored connectivity.
+	 */
+	const unsigned int* getTargets(unsigned int source) const;
+	
+	/**
+	 * @brief Draw the targets of a source neuron with the procedural connectivity.
+	 * 
+	 * The targets are spread over blocks of 64 neurons: a source has a fixed number of targets in each block
+	 * (proportional to its size) that are uniformly drawn inside the block. The random numbers only depend
+	 * on the source, the block and the seed of the network: the same targets are drawn at each call.
+	 * 
+	 * @param source is the source neuron
+	 * @param begin is the first neuron of the targets range (multiple of 64)
+	 * @param end is the neuron following the last neuron of the targets range (multiple of 64 or N)
+	 * @param targets receives the targets of source inside [begin, end), sorted by block
+	 * 
+	 * @note Each source neuron has 0.1*N targets. Each neuron receives in average 0.1*Ne excitatory connections
+	 * and 0.1*Ni inhibitory connections (the number is not fixed as with the stored connectivity).
+	 */
+	void drawTargets(unsigned int source, unsigned int begin, unsigned int end, std::vector<unsigned int>& targets) const;
+	
+	/**
+	 * @brief Transmit spikes of one step to the targets of the range [begin, end).
+	 * 
+	 * The spikes are written into the time buffer of the targets at index writeBox.
+	 * 
+	 * @param spikes are the neurons that spiked
+	 * @param writeBox is the index of the time buffer of the step
+	 * @param begin is the first target neuron
+	 * @param end is the neuron following the last target neuron
+	 * 
+	 * @note Called by update, public for the benchmarks of the transmission (neuron_bench).
+	 */
+	void deliverSpikes(const std::vector<unsigned int>& spikes, unsigned int writeBox, unsigned int begin, unsigned int end);
+	
+	/**
+	 * @brief Get the total number of connections of the network.
+	 */
+	size_t getNbConnections() const;
+	
+	/**
+	 * @brief Get the memory held by each structure of the network: connections (with the slack of their vectors),
+	 * neurons, delay ring, lists of the spikes, blocks of the recorder, rates, random numbers and profiler.
+	 */
+	MemoryReport getMemoryReport() const;
+	
+	/**
+	 * @brief Predict the memory of a network without building it (dry run), with the same structures as getMemoryReport.
+	 * 
+	 * The connections, the neurons, the delay ring and the blocks of the recorder are exact. The lists of the spikes
+	 * are bounded by all the neurons spiking at each step, the rates by their bins until stopTime, and the vectors
+	 * growing during the simulation are rounded to their largest capacity.
+	 * The peak adds the copy of the offsets of the connections made while they are drawn.
+	 * 
+	 * @param nbNeurons is the number of neurons
+	 * @param connectivity is the storage of the connections
+	 * @param parameters are the parameters of the model
+	 * @param nbThreads is the number of threads of the simulation
+	 * @param stopTime is the duration of the simulation [ms] (0: the rates and the profiler are empty)
+	 * @param binWidth is the width of the bins of the rates [ms] (0: one bin per step, the rates of Network)
+	 */
+	static MemoryReport planMemory(unsigned int nbNeurons, Connectivity connectivity, const Parameters& parameters = Parameters(),
+	                               unsigned int nbThreads = 1, double stopTime = 0.0, double binWidth = 0.0);
+	
+	/**
+	 * @brief Save the complete state of the simulation into a snapshot file (see snapshot.hpp).
+	 * 
+	 * The snapshot holds the state of the neurons and their time buffers, the clock, the seed and the connections.
+	 * The random numbers only depend on the seed and the step time: a network restored from the snapshot
+	 * continues exactly as the network saved.
+	 * 
+	 * @param path is the path of the snapshot
+	 * 
+	 * @return whether the snapshot could be written
+	 * 
+	 * @note The snapshot is written aside and then renamed: a snapshot is never partially written.
+	 */
+	bool save(const std::string& path) const;
+	
+	/**
+	 * @brief Restore the complete state of the simulation from a snapshot file.
+	 * 
+	 * @param path is the path of the snapshot
+	 * 
+	 * @return whether the snapshot could be read (same version and same number of neurons as the network,
+	 * valid parameters, connections between neurons of the network)
+	 * 
+	 * @note The network is unchanged if the snapshot could not be read. The files of the spikes of the restored
+	 * simulation start at the step of the snapshot.
+	 */
+	bool restore(const std::string& path);
+	
+	/**
+	 * @brief Save the state of the simulation periodically during update (see save).
+	 * 
+	 * @param path is the path of the snapshot, replaced at each save
+	 * @param interval is the time between two saves (ms), the saves are made at the end of the windows of steps
+	 * 
+	 * @note The state is also saved at the end of the simulation.
+	 */
+	void setCheckpoint(const std::string& path, double interval);
+	
 	/**
 	 * @brief Run the simulation of the network
 	 * 
 	 * Main simulation loop.
-	 * The network updates each neurons. 
+	 * The network updates each neurons of the population and adds the external spikes.
 	 * If a spike occurs in a neuron, the spike is transmitted to the connected neurons at current time t + delay.
+	 * @note The update of the neurons (and the external spikes) is made in parallel by the threads, each one on its partition,
+	 * for a window of steps (see setWindowSteps). The threads are all done before the spikes are transmitted.
+	 * The transmission is also made in parallel: each thread reads all the spikes of the window
+	 * but only writes into the time buffer of the targets of its partition (no lock is needed).
 	 * @note The network handles the recording into the time buffer of each neuron.
 	 */
 	void update();
 
 private:
 
+	/**
+	 * @brief Simulate a window of steps: update of the neurons, then transmission of the spikes and record.
+	 * 
+	 * @param nbSteps is the number of steps of the window (at most DelayStep)
+	 */
+	void simulateWindow(unsigned int nbSteps);
+	
+	/**
+	 * @brief Update the partition of thread t for a window of steps and list its spikes in threadSpikes_[t].
+	 */
+	void updatePartition(unsigned int t, unsigned int nbSteps);
+	
+	/**
+	 * @brief Transmit spikes of one step to the targets of the range [begin, end) with the procedural connectivity.
+	 */
+	void deliverProceduralSpikes(const std::vector<unsigned int>& spikes, unsigned int writeBox, unsigned int begin, unsigned int end);
+
+	/**
+	 * @brief Draw the connections of the network.
+	 * 
+	 * For each target neuron, the source neurons are drawn randomly (see connect).
+	 * 
+	 * @param connection is called for each connection with the source and the target, in order of the targets
+	 */
+	void drawConnections(const std::function<void(unsigned int, unsigned int)>& connection);
+
+	/**
+	 * @brief Common initialisation of the constructors: neuron types, connections and files.
+	 * 
+	 * @param seed is the seed of the connections and of the external spikes
+	 * @param outputDirectory is the directory of the files (none if empty)
+	 */
+	void init(uint64_t seed = DefaultSeed, const std::string& outputDirectory = "../res");
+
 	double networkStartTime_; //!< Start time of the simulation
 	
 	double networkStopTime_; //!< End time of the simulation
 	
-	std::vector<Neuron*> neurons_; //!< Table of neurons of the network
-
-	std::mt19937 generator; //!< Mester Twyster engine for random distribution
+	Parameters parameters_; //!< Parameters of the model
+	
+	NeuronPopulation population_; //!< State of all the neurons of the network
+	
+	std::vector<Neuron*> neurons_; //!< Views on the population given to the constructor (attached to population_)
+	
+	std::unique_ptr<ThreadPool> threads_; //!< Threads updating the neurons
+	
+	/**
+	 * @brief Bounds of the partitions of the neurons, one partition per thread.
+	 * 
+	 * The partition of thread t is [partitions_[t], partitions_[t+1]).
+	 * The bounds are multiple of BlockSize so that two threads never write on the same cache line.
+	 */
+	std::vector<unsigned int> partitions_;
+	
+	static const unsigned int BlockSize = 64; //!< Number of neurons of the blocks of partitions and procedural connections
 
-	std::poisson_distribution<unsigned int> distributionPoisson; //!< Poisson distribution for external spikes
+	uint64_t seed_; //!< Seed of the random numbers
+	
+	Philox::Key key_; //!< Key of the counter-based generator, computed from the seed
+	
+	uint64_t externalSeed_; //!< Seed of the external spikes
+	
+	Philox::Key externalKey_; //!< Key of the counter-based generator of the external spikes
+	
+	PoissonGenerator background_; //!< Poisson distribution of the external spikes, of mean dt*Vext
 	
 	unsigned int nbSpikesTotal_; //!< Number of spikes of all neurons that happen each step time.
 	
+	static const unsigned int WindowBlockSize = 1024; //!< Number of neurons of the chunks that go through a window together
+	
+	unsigned int windowSteps_; //!< Number of steps between two exchanges of spikes
+	
 	/**
-	 * @brief Matrix of index corresponding to neurons. 
+	 * @brief Index of the neurons that spiked during each step of the window, shared by the threads
 	 * 
-	 * The first vector contains all the source neurons of the network.
-	 * The second vector contains all the target of each source neuron.
+	 * Dense lists built from the spike mask of the population, read by the transmission, the record and the count of the spikes.
 	 */
-	std::vector<std::vector< unsigned int> > index_;
-
-	double clock_; //!< Global clock of the simulation
+	std::vector<std::vector<unsigned int> > windowSpikes_;
+	
+	std::vector<std::vector<std::vector<unsigned int> > > threadSpikes_; //!< Spikes of each step of the window found by each thread in its partition
 	
 	/**
-	 * @brief File for gnuplot graph
+	 * @brief Offsets of the targets of each source neuron in targets_
 	 * 
-	 * Record of the total number of spikes at each dt
-	 * Gnuplot graph: xrange: time in ms / yrange: number of spikes
+	 * The targets of source i are targets_[offsets_[i]] to targets_[offsets_[i+1]-1].
 	 */
-	std::ofstream* spikesFile_;
+	std::vector<size_t> offsets_;
+	
+	std::vector<unsigned int> targets_; //!< Targets of all the source neurons, source after source
+	
+	Connectivity connectivity_; //!< Storage of the connections
+
+	unsigned long clock_; //!< Global clock of the simulation (in step time)
+	
+	std::string checkpointPath_; //!< Snapshot saved periodically (none if empty)
+	
+	unsigned long checkpointSteps_; //!< Steps between two snapshots
+	
+	static const uint32_t SnapshotVersion = 3; //!< Version of the snapshots written
 	
 	/**
-	 * @brief File for Jupyter graphs
+	 * @brief Recorder of the spikes, writing the files from its own thread
+	 * 
+	 * File for gnuplot graph "spikes2.txt":
+	 * Record of the total number of spikes at each dt
+	 * Gnuplot graph: xrange: time in ms / yrange: number of spikes
 	 * 
+	 * Binary spike file "spikes.bin" for the Jupyter graphs:
 	 * Record of the each neuron index that spikes and its corresponding time spike
 	 * First jupyter graph:  xrange: time in ms / yrange: index of the first 50 neurons
 	 * Second jupyter graph: xrange: time in ms / yrange: spikes count
 	 */
-	std::ofstream* spikesIndexFile_;
+	AsyncRecorder recorder_;
+	
+	SpikeSelection spikeSelection_; //!< Neurons and time window of the spikes recorded in "spikes.bin"
+	
+	std::vector<unsigned int> selectedSpikes_; //!< Spikes of a step selected for the record
+	
+	RateRecorder rates_; //!< Spikes counted in bins of time, written in "rates.csv"
+	
+	std::string outputDirectory_; //!< Directory of the files of the simulation
+	
+	Profiler profiler_; //!< Time spent in each phase of the simulation (see PROFILE_PHASE)
 	
 	/**
 	 * @brief Buffer index in which your record file
 	 * 
 	 * Index in which your record spike taking into account the Delay. 
-	 * Is incremented each dt, when index 14 is reached, writeBox is set to 0
+	 * Is incremented each dt, when index DelayStep is reached, writeBox is set to 0
 	 */
 	unsigned int writeBox_;
 	
@@ -185,7 +649,7 @@ private:
 	 * @brief Buffer index in which your read file
 	 * 
 	 * Index in which your read spike taking into account the Delay. 
-	 * Is incremented each dt, when index 14 is reached, readBox is set to 0
+	 * Is incremented each dt, when index DelayStep is reached, readBox is set to 0
 	 */
 	unsigned int readBox_;
 	
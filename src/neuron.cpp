@@ -5,18 +5,12 @@ using namespace std;
 //======================================================================
 //constructeurs/destructeurs
 Neuron::Neuron(double stopTime, double iext, double potential)
-: stopTime_(stopTime), iext_(iext), potential_(potential)
+: stopTime_(stopTime), time_(0), own_(1), population_(&own_), id_(0)
 {
-	//on initialise pour le moment le start time à 0 par défaut (à voir pour la suite)
-	hasSpike_ = false;
-	isInhibiter_ = false;
-	refractoryTime_ = 0;
-	nbSpikes_ = 0;
-	time_ = 0;
-
 	//la taille du buffer initial est 15 (soit 16 cases).
 	//de ce fait, il y aura un délai de 15 cases pour qu'un spike s'y inscrive, soit 1.5 ms
-	buffer_.resize(DelayStep+1);
+	own_.setIext(0, iext);
+	own_.setPotential(0, potential);
 }	
 Neuron::~Neuron()
 {}
@@ -24,87 +18,90 @@ Neuron::~Neuron()
 //Getters
 double Neuron::getPotential() const
 {
-	return potential_;
+	return population_->getPotential(id_);
 }
 //----------------------------------------------------------------------
 unsigned int Neuron::getNbSpikes() const
 {
-	return nbSpikes_;
+	return population_->getNbSpikes(id_);
 }
 //----------------------------------------------------------------------
 int Neuron::getRefractoryTime() const
 {
-	return refractoryTime_;
+	return population_->getRefractoryTime(id_);
 }
 //----------------------------------------------------------------------
 bool Neuron::hasSpike() const
 {
-	return hasSpike_;
+	return population_->hasSpike(id_);
 }
 //----------------------------------------------------------------------
 bool Neuron::isInhibiter() const
 {
-	return isInhibiter_;
+	return population_->isInhibiter(id_);
+}
+//----------------------------------------------------------------------
+double Neuron::getBuffer(size_t box) const
+{
+	return population_->getBuffer(id_, box);
 }
 //======================================================================
 //Setters
 void Neuron::setPotential(double potential)
 {
-	potential_ = potential;
+	population_->setPotential(id_, potential);
 }
 //----------------------------------------------------------------------
 void Neuron::setIext(double Iext)
 {
-	iext_ = Iext;
+	population_->setIext(id_, Iext);
 }
 //----------------------------------------------------------------------
 void Neuron::setIsInhibiter(bool type)
 {
-	isInhibiter_ = type;
+	population_->setIsInhibiter(id_, type);
+}
+//======================================================================
+//Attachement to the population of a network
+void Neuron::attach(NeuronPopulation* population, unsigned int i)
+{
+	assert(population != nullptr);
+	
+	population->copyNeuron(i, *population_, id_);
+	population_ = population;
+	id_ = i;
+}
+//----------------------------------------------------------------------
+void Neuron::detach()
+{
+	if (population_ != &own_) {
+		own_.copyNeuron(0, *population_, id_);
+		population_ = &own_;
+		id_ = 0;
+	}
 }
 //======================================================================
 //Membrane equation : temporal evolution of the membrane potential
 double Neuron::membraneEq(size_t readBox) //
 {
-	assert(!buffer_.empty());
-	return e*potential_ + iext_*Resistance*OneMinus_e + buffer_[readBox]*Amplitude;
+	return population_->membraneEq(id_, readBox);
 }
 //======================================================================
 // Gestion du buffer
 void Neuron::fillBuffer(double spike, size_t writeBox)
 {
-	buffer_[writeBox] += spike;
+	population_->fillBuffer(id_, spike, writeBox);
 }
 //======================================================================
 //update du potentiel
 void Neuron::update(size_t readBox)
 {	
-	hasSpike_ = false;
-	// if the refractory time is greater than the refractory period	
-	if (refractoryTime_ > 0) { 
-		// We reset the potential to 0.0 because the neuron is in a refractory state and cannot receive  any spikes.
-		potential_ = PotentialReset;
-		
-		// refractoryTime decrementation
-		--refractoryTime_;
-	
-	//if the potential is greater than threshold
-	} else if (potential_ > Threshold) {
-		
-		//The neuron spikes
-		hasSpike_ = true;
-		++nbSpikes_;
-//		cout << "spikeTime: " << nbSpikes_ << ": " << time_*0.1 << endl;
-		
-		// = tauRp/dt,the refractory time is expressed in steptime
-		refractoryTime_ = RefractoryStep -1; 
+	// if the refractory time is greater than the refractory period, the potential is reset,
+	// else if the potential is greater than threshold the neuron spikes,
+	// otherwise we calculate the new accurate value of the potential (see NeuronPopulation::update)
+	population_->update(id_, readBox);
 	
-	//if the potential is smaller thant  the Threshold
-	} else {
-		
-		//we calculate the new accurate value of the potential 
-		potential_ = membraneEq(readBox);
-	}
+//	if (hasSpike()) cout << "spikeTime: " << getNbSpikes() << ": " << time_*0.1 << endl;
 	++time_;
 }
 //======================================================================
@@ -7,28 +7,8 @@
 #include <fstream>
 #include <list>
 #include <math.h>
-
-///Constants
-
-const double g = 5.0;							//!< Relative strength of inhibitory synapses
-const double Eta = 2.0;							//!< Eta function
-
-const double Threshold = 20.0; 					//!< Maximum potential limit [mV]
-const double PotentialReset = 0.0; 				//!< Potential reset  [mV]
-const double dt = 0.1; 							//!< Time variation [ms]
-const unsigned int h = 1; 						//!< Steptime (will be converted en ms)
-const double Resistance = 20.0; 				//!< Membrane Resistance [Ohm]
-const double Capacity = 1.0; 					//!< Capacity [Farrad]
-const double tau = Resistance * Capacity; 		//!< Tau excitatory
-const double e = exp(-dt/tau);					//!< needed for the membrane equation
-const double OneMinus_e = 1 - e;				//!< needed for the membrane equation 
-const double tauRp = 2.0; 						//!< Refractory time period [ms]
-const double Amplitude = 0.1; 					//!< Spike Amplitude received from excitatory neurons
-const double Delay = 1.5; 						//!< Transmission delay [ms]
-const double ConnectionPercent = 0.1;			//!< Connections pourcentage in the whole network
-const double Vext = Threshold * Eta /(Amplitude*tau); //!< External frequency
-const unsigned int DelayStep = static_cast<unsigned long>(floor(Delay/dt)); //!< Delay in steps
-const unsigned int RefractoryStep = static_cast<unsigned long>(floor(tauRp/dt)); //!< Refractory period in steps
+#include "constants.hpp"
+#include "population.hpp"
 
 /*! 
  * @class Neuron
@@ -157,32 +137,56 @@ public:
 	void fillBuffer(double spike, size_t writeBox);
 
 	/**
-	 * @brief Buffer of size delay + 1
+	 * @brief Get the content of the time buffer.
 	 * 
-	 * In network there are two index readBox and WriteBox that define where to read and wrtie spikes transmitted by other neurons.
-	 * Hence, if I received a spike at time t, it will be read in the buffer case t+ Delay.
-	 * If a neuron transmit a spike at time t, I write it in the buffer case t + Delay.
+	 * @param box is the index of the buffer case
+	 * 
+	 * @return the sum of the spikes recorded in this case
 	 */
-	std::vector<int> buffer_; //!< Time buffer containing each spike received at each dt (public for optimisation purpose)
+	double getBuffer(size_t box) const;
 	
+	/**
+	 * @brief Attach the neuron to an entry of the population of a network.
+	 * 
+	 * The state of the neuron is copied into the entry i of the population.
+	 * From then on, the neuron is only a view on this entry: the network updates the population
+	 * and the getters of the neuron read the population.
+	 * 
+	 * @param population is the population of the network
+	 * @param i is the index of the neuron inside the population
+	 */
+	void attach(NeuronPopulation* population, unsigned int i);
+	
+	/**
+	 * @brief Detach the neuron from the population of a network.
+	 * 
+	 * The state of the population entry is copied back into the neuron own storage.
+	 */
+	void detach();
+
+	/**
+	 * @brief A neuron is a view on a population: it cannot be copied.
+	 */
+	Neuron(const Neuron&) = delete;
+	Neuron& operator=(const Neuron&) = delete;
 
 private:
 	
 	double stopTime_; //!< StopTime of the neuron simulation (needed for gtest).	
 	
-	int refractoryTime_; //!< Refractory timer: is set to 20 time step and will be decremented when the neuron is refractory.
-	
-	double iext_; //!< External Current
-				
-	double potential_; //!< Membrane potential
-
-	unsigned int nbSpikes_; //!< Number of spikes
+	unsigned int time_; //!< clock_ of the neuron simulation. Only needed for the cout in the gtest
 	
-	bool hasSpike_; //!< Neuron spike state
+	/**
+	 * @brief Own storage of the neuron
+	 * 
+	 * Population of one neuron used while the neuron is not attached to a network.
+	 * It holds the potential, refractory timer, external current, spikes and time buffer of size delay + 1.
+	 */
+	NeuronPopulation own_;
 	
-	bool isInhibiter_; //!< Neuron type: return true if is inhibiter return false if is excitatory
+	NeuronPopulation* population_; //!< Population the neuron is a view on (own_ or the population of a network)
 	
-	unsigned int time_; //!< clock_ of the neuron simulation. Only needed for the cout in the gtest
+	unsigned int id_; //!< Index of the neuron inside population_
 };
 
 
@@ -0,0 +1,246 @@
+#include "network.hpp"
+#include "population.hpp"
+#include "poisson.hpp"
+#include "parameters.hpp"
+#include "random.hpp"
+#include "spike_codec.hpp"
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <cstdio>
+#include <algorithm>
+
+using namespace std;
+
+// Micro-benchmarks of the hot kernels of the simulation
+// Usage: ./neuron_bench [--benchmark_filter=regex] (see the options of Google Benchmark)
+// The arguments of the benchmarks are the number of neurons N, the graph of figure 8 (0 to 3 for A to D)
+// and the number of threads. The rates are reported as neuron_updates/s and synaptic_events/s.
+
+//======================================================================
+//Firing regimes: the four graphs of figure 8 of Brunel's paper
+static Parameters getGraph(int graph)
+{
+	static const double G[] = { 3.0, 6.0, 5.0, 4.5 };
+	static const double Etas[] = { 2.0, 4.0, 2.0, 0.9 };
+
+	Parameters parameters;
+	parameters.g = G[graph];
+	parameters.eta = Etas[graph];
+	return parameters;
+}
+//----------------------------------------------------------------------
+// Network of N neurons of a graph after 100 ms (the transient), with the spikes of the steps following it
+struct Regime {
+	unique_ptr<Network> network; //!< Network at the end of the transient
+	vector<vector<unsigned int> > spikes; //!< Spikes of successive steps, drawn with the rates of the neurons
+	vector<size_t> nbSynapticEvents; //!< Number of targets of the spikes of each step
+};
+//----------------------------------------------------------------------
+static Regime& getRegime(unsigned int nbNeurons, int graph)
+{
+	static map<pair<unsigned int, int>, Regime> regimes;
+
+	Regime& regime = regimes[make_pair(nbNeurons, graph)];
+	if (regime.network) {
+		return regime;
+	}
+
+	const double transient(100.0);
+	regime.network.reset(new Network(transient, nbNeurons, Connectivity::Stored, getGraph(graph), Network::DefaultSeed, ""));
+	regime.network->update();
+
+	// each neuron spikes at each step with the probability given by its rate during the transient
+	const NeuronPopulation& population = regime.network->getPopulation();
+	const unsigned int nbSteps(100);
+	regime.spikes.assign(nbSteps, vector<unsigned int>());
+	regime.nbSynapticEvents.assign(nbSteps, 0);
+
+	for (unsigned int s(0); s < nbSteps; ++s) {
+		for (unsigned int i(0); i < nbNeurons; ++i) {
+			double probability = population.getNbSpikes(i)*dt/transient;
+			uint32_t random = Philox::generate({{ i, s, 0, 0 }}, Philox::key(1))[0];
+			if (Philox::toUniform(random) < probability) {
+				regime.spikes[s].push_back(i);
+				regime.nbSynapticEvents[s] += regime.network->getNbTargets(i);
+			}
+		}
+	}
+	return regime;
+}
+//======================================================================
+//Membrane kernel: update of all the neurons at one step
+static void BM_NeuronUpdate(benchmark::State& state)
+{
+	unsigned int nbNeurons = state.range(0);
+	
+	// the neurons of the largest populations repeat those of a network of 12500 neurons (the simulation would be too long)
+	const NeuronPopulation& regime = getRegime(min(nbNeurons, 12500u), state.range(1)).network->getPopulation();
+	NeuronPopulation population(nbNeurons, regime.getNbSlots());
+	for (unsigned int i(0); i < nbNeurons; ++i) {
+		population.copyNeuron(i, regime, i % regime.size());
+	}
+
+	for (auto _ : state) {
+		population.update(0, nbNeurons, 0);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations()*nbNeurons);
+	state.counters["neuron_updates"] = benchmark::Counter(state.iterations()*double(nbNeurons), benchmark::Counter::kIsRate);
+	state.SetLabel(getName(population.getKernel()));
+}
+BENCHMARK(BM_NeuronUpdate)->ArgNames({ "N", "graph" })->ArgsProduct({ { 1250, 12500, 125000 }, { 0, 1, 2, 3 } });
+//----------------------------------------------------------------------
+//Transmission of the spikes of one step to their stored targets
+static void BM_Delivery(benchmark::State& state)
+{
+	unsigned int nbNeurons = state.range(0);
+	Regime& regime = getRegime(nbNeurons, state.range(1));
+
+	size_t step(0);
+	size_t nbSynapticEvents(0);
+	for (auto _ : state) {
+		size_t s = step++ % regime.spikes.size();
+		regime.network->deliverSpikes(regime.spikes[s], 0, 0, nbNeurons);
+		nbSynapticEvents += regime.nbSynapticEvents[s];
+	}
+
+	state.SetItemsProcessed(nbSynapticEvents);
+	state.counters["synaptic_events"] = benchmark::Counter(nbSynapticEvents, benchmark::Counter::kIsRate);
+	state.counters["spikes_per_step"] = double(regime.spikes[0].size());
+}
+BENCHMARK(BM_Delivery)->ArgNames({ "N", "graph" })->ArgsProduct({ { 1250, 12500 }, { 0, 1, 2, 3 } });
+//----------------------------------------------------------------------
+//Drawing of the stored connections
+static void BM_Connect(benchmark::State& state)
+{
+	Network network(0.0, state.range(0), Connectivity::Stored, Parameters(), Network::DefaultSeed, "");
+
+	for (auto _ : state) {
+		network.connect();
+	}
+
+	state.SetItemsProcessed(state.iterations()*network.getNbConnections());
+	state.counters["synapses"] = benchmark::Counter(state.iterations()*double(network.getNbConnections()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Connect)->ArgName("N")->Arg(1250)->Arg(12500)->Unit(benchmark::kMillisecond);
+//----------------------------------------------------------------------
+//External spikes: one neuron at a time (Network::poisson), or in bulk for a partition (PoissonGenerator::fill)
+static void BM_Poisson(benchmark::State& state)
+{
+	unsigned int nbNeurons = state.range(0);
+	Network network(0.0, 64, Connectivity::Procedural, getGraph(state.range(1)), Network::DefaultSeed, "");
+
+	unsigned long step(0);
+	for (auto _ : state) {
+		unsigned int total(0);
+		for (unsigned int i(0); i < nbNeurons; ++i) {
+			total += network.poisson(i, step);
+		}
+		benchmark::DoNotOptimize(total);
+		++step;
+	}
+	state.SetItemsProcessed(state.iterations()*nbNeurons);
+	state.counters["neuron_updates"] = benchmark::Counter(state.iterations()*double(nbNeurons), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Poisson)->ArgNames({ "N", "graph" })->ArgsProduct({ { 12500 }, { 0, 1, 2, 3 } });
+//----------------------------------------------------------------------
+static void BM_PoissonFill(benchmark::State& state)
+{
+	unsigned int nbNeurons = state.range(0);
+	Parameters parameters = getGraph(state.range(1));
+	PoissonGenerator generator(parameters.dt*parameters.getExternalFrequency());
+	vector<double> slot(nbNeurons, 0.0);
+
+	unsigned long step(0);
+	for (auto _ : state) {
+		// the stream of the external spikes of the network
+		generator.fill(Philox::key(Network::DefaultSeed), Network::PoissonStream, step++, 0, nbNeurons, slot.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations()*nbNeurons);
+	state.counters["neuron_updates"] = benchmark::Counter(state.iterations()*double(nbNeurons), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PoissonFill)->ArgNames({ "N", "graph" })->ArgsProduct({ { 12500 }, { 0, 1, 2, 3 } });
+//----------------------------------------------------------------------
+//Decode of a block of the compressed spike archive, the spikes of 100 steps of a graph
+static void BM_Decode(benchmark::State& state)
+{
+	unsigned int nbNeurons = state.range(0);
+	Regime& regime = getRegime(nbNeurons, state.range(1));
+	vector<SpikeRecord> records;
+	for (uint32_t s(0); s < regime.spikes.size(); ++s) {
+		for (auto neuron : regime.spikes[s]) {
+			records.push_back({ s, neuron });
+		}
+	}
+	vector<uint8_t> encoded;
+	SpikeCodec::encode(records.data(), records.size(), 0, nbNeurons, encoded);
+	vector<SpikeRecord> decoded(records.size());
+
+	for (auto _ : state) {
+		if (not SpikeCodec::decode(encoded.data(), encoded.size(), 0, nbNeurons, decoded.size(), decoded.data())) {
+			state.SkipWithError("corrupt block");
+			break;
+		}
+		benchmark::ClobberMemory();
+	}
+	// bytes of the records decoded (8 bytes per spike, as in the binary spike file)
+	state.SetBytesProcessed(state.iterations()*records.size()*sizeof(SpikeRecord));
+	state.counters["spikes"] = benchmark::Counter(state.iterations()*double(records.size()), benchmark::Counter::kIsRate);
+	state.counters["compression"] = double(records.size()*sizeof(SpikeRecord))/encoded.size();
+}
+BENCHMARK(BM_Decode)->ArgNames({ "N", "graph" })->ArgsProduct({ { 12500 }, { 0, 1, 2, 3 } });
+//----------------------------------------------------------------------
+//Whole simulation of 10 ms after the transient: update, external spikes, transmission and record of the spikes
+static void BM_NetworkStep(benchmark::State& state)
+{
+	unsigned int nbNeurons = state.range(0);
+	unsigned int nbThreads = state.range(2);
+	const double duration(10.0);
+	Regime& regime = getRegime(nbNeurons, state.range(1));
+	if (not regime.network->save("neuron_bench.snapshot")) {
+		state.SkipWithError("Error opening file neuron_bench.snapshot");
+		return;
+	}
+
+	double nbUpdates(0.0), nbSynapticEvents(0.0);
+	for (auto _ : state) {
+		// the connections come from the snapshot: the network is built without drawing them
+		state.PauseTiming();
+		Network network(100.0 + duration, nbNeurons, Connectivity::Procedural, getGraph(state.range(1)), Network::DefaultSeed, "");
+		if (not network.restore("neuron_bench.snapshot")) {
+			state.ResumeTiming();
+			state.SkipWithError("Error opening file neuron_bench.snapshot");
+			break;
+		}
+		network.setNbThreads(nbThreads);
+		unsigned long nbSpikes(0);
+		for (unsigned int i(0); i < nbNeurons; ++i) {
+			nbSpikes -= network.getPopulation().getNbSpikes(i);
+		}
+		state.ResumeTiming();
+
+		network.update();
+
+		state.PauseTiming();
+		for (unsigned int i(0); i < nbNeurons; ++i) {
+			nbSpikes += network.getPopulation().getNbSpikes(i);
+		}
+		nbUpdates += double(nbNeurons)*(duration/dt);
+		nbSynapticEvents += double(nbSpikes)*network.getNbConnections()/nbNeurons;
+		state.ResumeTiming();
+	}
+	remove("neuron_bench.snapshot");
+
+	state.counters["neuron_updates"] = benchmark::Counter(nbUpdates, benchmark::Counter::kIsRate);
+	state.counters["synaptic_events"] = benchmark::Counter(nbSynapticEvents, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_NetworkStep)->ArgNames({ "N", "graph", "threads" })
+                         ->ArgsProduct({ { 12500 }, { 0, 1, 2, 3 }, { 1, 2, 4, 8 } })
+                         ->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(10);
+//======================================================================
+BENCHMARK_MAIN();
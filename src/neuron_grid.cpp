@@ -0,0 +1,62 @@
+#include "sweep.hpp"
+#include "parameters.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+// Sweep of a grid of (g, Eta, seed), one network per point on the threads of the machine
+// Usage: ./neuron_grid nbNeurons stopTime summary.csv [threads [memory [transient [stored|procedural]]]] axes parameters
+// The axes are g=first:last:step, Eta=v1,v2,v3 or seed=v (see SweepGrid), the parameters are given as for ./neuron.
+// The memory (MB) limits the number of networks simulated at the same time, 0 for no limit.
+// The summary of each point is appended to summary.csv; the same command resumes an interrupted sweep.
+int main(int argc, char** argv)
+{
+	// the axes of the grid are the assignments of g, Eta and seed, the other arguments are for the parameters
+	SweepGrid grid;
+	vector<char*> others(1, argv[0]);
+	for (int i(1); i < argc; ++i) {
+		bool isAxis = strncmp(argv[i], "g=", 2) == 0 or strncmp(argv[i], "Eta=", 4) == 0 or strncmp(argv[i], "seed=", 5) == 0;
+		if (isAxis and not grid.set(argv[i])) {
+			cerr << "Invalid axis " << argv[i] << endl;
+			return 1;
+		} else if (not isAxis) {
+			others.push_back(argv[i]);
+		}
+	}
+	
+	Parameters parameters;
+	vector<string> arguments;
+	if (not parameters.parse(others.size(), others.data(), arguments) or not parameters.isValid() or arguments.size() < 3) {
+		cerr << "Usage: " << argv[0] << " nbNeurons stopTime summary.csv [threads [memory [transient [stored|procedural]]]]"
+		     << " g=first:last:step Eta=v1,v2 seed=v [name=value...]" << endl;
+		return 1;
+	}
+	
+	unsigned int nbNeurons = strtoul(arguments[0].c_str(), nullptr, 10);
+	double stopTime = atof(arguments[1].c_str());
+	Connectivity connectivity = (arguments.size() > 6 and arguments[6] == "procedural") ? Connectivity::Procedural : Connectivity::Stored;
+	
+	SweepScheduler scheduler(stopTime, nbNeurons, connectivity, parameters);
+	if (arguments.size() > 3 and atoi(arguments[3].c_str()) > 0) {
+		scheduler.setNbThreads(atoi(arguments[3].c_str()));
+	}
+	if (arguments.size() > 4) {
+		scheduler.setMemoryLimit(strtoull(arguments[4].c_str(), nullptr, 10) << 20);
+	}
+	if (arguments.size() > 5) {
+		scheduler.setTransient(atof(arguments[5].c_str()));
+	}
+	
+	vector<SweepPoint> points = grid.getPoints(parameters);
+	cout << points.size() << " points, " << scheduler.getNbConcurrent() << " networks of "
+	     << (scheduler.getNetworkMemory() >> 20) << " MB at the same time" << endl;
+	
+	unsigned int nbSimulated;
+	if (not scheduler.run(points, arguments[2], nbSimulated)) {
+		return 1;
+	}
+	cout << nbSimulated << " points simulated, " << points.size() - nbSimulated << " already done" << endl;
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include "scaling.hpp"
+#include "parameters.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+// Strong and weak scaling of whole simulations, one forked process per configuration
+// Usage: ./neuron_scaling [neurons=1000,10000,...] [connectivity=stored,procedural] [threads=1,2,4] [time=100]
+//                         [scaling=strong|weak] [output=scaling.json] [baseline=file [threshold=0.5]] [name=value...]
+// Every combination of the numbers of neurons, connectivities and threads is simulated during time ms.
+// With scaling=weak the numbers of neurons are per thread. The results are written as JSON to output;
+// with a baseline (a previous output) the command fails when a simulation is more than 1+threshold times slower.
+// The parameters of the model are given as for ./neuron.
+
+//======================================================================
+//Values of an option "name=v1,v2,v3"
+static vector<string> split(const string& values)
+{
+	vector<string> list;
+	istringstream in(values);
+	string value;
+	while (getline(in, value, ',')) {
+		list.push_back(value);
+	}
+	return list;
+}
+//----------------------------------------------------------------------
+static vector<unsigned int> splitNumbers(const string& values)
+{
+	vector<unsigned int> numbers;
+	for (const string& value : split(values)) {
+		numbers.push_back(strtoul(value.c_str(), nullptr, 10));
+	}
+	return numbers;
+}
+//======================================================================
+int main(int argc, char** argv)
+{
+	unsigned int nbCores = max(1u, thread::hardware_concurrency());
+	vector<unsigned int> nbNeurons = { 1000, 10000, 100000, 1000000 };
+	vector<Connectivity> connectivities = { Connectivity::Stored, Connectivity::Procedural };
+	vector<unsigned int> nbThreads = { 1 };
+	for (unsigned int threads(2); threads <= nbCores; threads *= 2) {
+		nbThreads.push_back(threads);
+	}
+	double stopTime(100.0);
+	bool weak(false);
+	string outputPath("scaling.json");
+	string baselinePath;
+	double threshold(0.5);
+
+	// the options of the scaling run, the other arguments are for the parameters
+	vector<char*> others(1, argv[0]);
+	bool valid(true);
+	for (int i(1); i < argc; ++i) {
+		string argument(argv[i]);
+		string value = argument.substr(argument.find('=') + 1);
+
+		if (argument.compare(0, 8, "neurons=") == 0) {
+			nbNeurons = splitNumbers(value);
+		} else if (argument.compare(0, 13, "connectivity=") == 0) {
+			connectivities.clear();
+			for (const string& name : split(value)) {
+				valid = valid and (name == "stored" or name == "procedural");
+				connectivities.push_back(name == "procedural" ? Connectivity::Procedural : Connectivity::Stored);
+			}
+		} else if (argument.compare(0, 8, "threads=") == 0) {
+			nbThreads = splitNumbers(value);
+		} else if (argument.compare(0, 5, "time=") == 0) {
+			stopTime = atof(value.c_str());
+		} else if (argument.compare(0, 8, "scaling=") == 0) {
+			valid = valid and (value == "strong" or value == "weak");
+			weak = value == "weak";
+		} else if (argument.compare(0, 7, "output=") == 0) {
+			outputPath = value;
+		} else if (argument.compare(0, 9, "baseline=") == 0) {
+			baselinePath = value;
+		} else if (argument.compare(0, 10, "threshold=") == 0) {
+			threshold = atof(value.c_str());
+		} else {
+			others.push_back(argv[i]);
+		}
+	}
+
+	Parameters parameters;
+	vector<string> arguments;
+	if (not valid or not parameters.parse(others.size(), others.data(), arguments) or not parameters.isValid() or not arguments.empty()) {
+		cerr << "Usage: " << argv[0] << " [neurons=1000,10000] [connectivity=stored,procedural] [threads=1,2,4] [time=100]"
+		     << " [scaling=strong|weak] [output=scaling.json] [baseline=file [threshold=0.5]] [name=value...]" << endl;
+		return 1;
+	}
+
+	vector<ScalingResult> baseline;
+	if (not baselinePath.empty()) {
+		baseline = readScalingResults(baselinePath);
+		if (baseline.empty()) {
+			cerr << "Error opening file " << baselinePath << endl;
+			return 1;
+		}
+	}
+
+	// the configurations that do not fit in the memory of the machine are skipped
+	size_t memory = static_cast<size_t>(sysconf(_SC_PHYS_PAGES))*sysconf(_SC_PAGE_SIZE);
+	vector<ScalingResult> results;
+	unsigned int nbFailed(0);
+
+	for (const ScalingConfiguration& configuration : getScalingConfigurations(nbNeurons, connectivities, nbThreads, weak)) {
+		cout << configuration.nbNeurons << " neurons, " << getName(configuration.connectivity) << ", "
+		     << configuration.nbThreads << " threads: ";
+
+		size_t peak = Network::planMemory(configuration.nbNeurons, configuration.connectivity, parameters,
+		                                  configuration.nbThreads, stopTime).getPeak();
+		if (peak > memory/2) {
+			cout << "skipped (" << (peak >> 20) << " MB)" << endl;
+			continue;
+		}
+
+		ScalingResult result;
+		if (not runScaling(configuration, stopTime, parameters, result)) {
+			cout << "failed" << endl;
+			++nbFailed;
+			continue;
+		}
+		cout << result.wallSeconds << " s (x" << result.realTimeFactor << " real time), " << result.peakMemory << " MB, "
+		     << result.spikesPerSecond << " spikes/s" << endl;
+		results.push_back(result);
+	}
+
+	ofstream output(outputPath);
+	if (not output) {
+		cerr << "Error opening file " << outputPath << endl;
+		return 1;
+	}
+	writeScalingResults(output, results);
+
+	unsigned int nbRegressions(0);
+	if (not baseline.empty()) {
+		nbRegressions = compareScaling(results, baseline, threshold, cout);
+		cout << nbRegressions << " regressions (threshold " << threshold << ")" << endl;
+	}
+	return (nbFailed > 0 or nbRegressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+#include "network.hpp"
+#include "sweep.hpp"
+#include "parameters.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+// Parameter sweep from an equilibrated snapshot, one forked process per point
+// Usage: ./neuron_sweep snapshot nbNeurons stopTime directory [processes [threads]] < points
+// The points are read on the standard input, one line "g eta seed" per point.
+// The files of point k are written in directory/pointk.
+// The step time and the delay must be those of the snapshot: they are given as for ./neuron (dt=0.05 Delay=1.5)
+int main(int argc, char** argv)
+{
+	Parameters parameters;
+	vector<string> arguments;
+	if (not parameters.parse(argc, argv, arguments) or not parameters.isValid() or arguments.size() < 4) {
+		cerr << "Usage: " << argv[0] << " snapshot nbNeurons stopTime directory [processes [threads]] < points" << endl;
+		return 1;
+	}
+	
+	unsigned int nbNeurons = strtoul(arguments[1].c_str(), nullptr, 10);
+	double stopTime = atof(arguments[2].c_str());
+	unsigned int nbProcesses = arguments.size() > 4 ? strtoul(arguments[4].c_str(), nullptr, 10) : 1;
+	unsigned int nbThreads = arguments.size() > 5 ? strtoul(arguments[5].c_str(), nullptr, 10) : 1;
+	
+	// the connections, the state of the neurons and the other parameters come from the snapshot:
+	// the network is built procedural, so that no connection is drawn only to be replaced
+	Network network(stopTime, nbNeurons, Connectivity::Procedural, parameters);
+	if (not network.restore(arguments[0])) {
+		cerr << "Error opening file " << arguments[0] << endl;
+		return 1;
+	}
+	
+	vector<SweepPoint> points = readSweepPoints(cin);
+	cout << points.size() << " points from " << network.getClock()*parameters.dt << " ms to " << stopTime << " ms" << endl;
+	
+	unsigned int nbFailed = runForkedSweep(network, points, arguments[3], max(1u, nbProcesses), max(1u, nbThreads));
+	if (nbFailed > 0) {
+		cerr << nbFailed << " points failed" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include "parameters.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+
+using namespace std;
+
+//======================================================================
+//Names of the parameters, as the constants of constants.hpp
+static const struct {
+	const char* name;
+	double Parameters::* value;
+} Names[] = {
+	{ "g", &Parameters::g },
+	{ "Eta", &Parameters::eta },
+	{ "Threshold", &Parameters::threshold },
+	{ "PotentialReset", &Parameters::potentialReset },
+	{ "dt", &Parameters::dt },
+	{ "Resistance", &Parameters::resistance },
+	{ "Capacity", &Parameters::capacity },
+	{ "tauRp", &Parameters::tauRp },
+	{ "Amplitude", &Parameters::amplitude },
+	{ "Delay", &Parameters::delay },
+	{ "ConnectionPercent", &Parameters::connectionPercent },
+};
+//======================================================================
+//Derived parameters, computed as in constants.hpp
+double Parameters::getTau() const
+{
+	return resistance * capacity;
+}
+//----------------------------------------------------------------------
+double Parameters::getDecay() const
+{
+	return exp(-dt/getTau());
+}
+//----------------------------------------------------------------------
+double Parameters::getExternalFrequency() const
+{
+	return threshold * eta /(amplitude*getTau());
+}
+//----------------------------------------------------------------------
+unsigned int Parameters::getDelaySteps() const
+{
+	// rounded: the delays given in ms (1.2, 0.3) are not exact multiples of dt in floating point
+	return max(0L, lround(delay/dt));
+}
+//----------------------------------------------------------------------
+unsigned int Parameters::getRefractorySteps() const
+{
+	return max(0L, lround(tauRp/dt));
+}
+//----------------------------------------------------------------------
+MembraneConstants Parameters::getMembraneConstants() const
+{
+	double decay = getDecay();
+	return { threshold, potentialReset, decay, resistance, 1 - decay, amplitude, static_cast<int>(getRefractorySteps()) };
+}
+//----------------------------------------------------------------------
+bool Parameters::isValid() const
+{
+	return dt > 0.0 and getTau() > 0.0 and amplitude > 0.0 and tauRp >= 0.0 and eta >= 0.0
+	       and getDelaySteps() >= 1 and connectionPercent >= 0.0 and connectionPercent <= 1.0;
+}
+//======================================================================
+//Assignments
+bool Parameters::set(const string& name, double value)
+{
+	for (const auto& parameter : Names) {
+		if (name == parameter.name) {
+			this->*parameter.value = value;
+			return true;
+		}
+	}
+	return false;
+}
+//----------------------------------------------------------------------
+bool Parameters::set(const string& assignment)
+{
+	size_t equal = assignment.find('=');
+	if (equal == string::npos) {
+		return false;
+	}
+
+	// the whole value must be a number
+	string value = assignment.substr(equal + 1);
+	char* end;
+	double number = strtod(value.c_str(), &end);
+	if (value.empty() or *end != '\0') {
+		return false;
+	}
+	return set(assignment.substr(0, equal), number);
+}
+//----------------------------------------------------------------------
+bool Parameters::read(istream& in)
+{
+	bool valid(true);
+	string line;
+
+	while (getline(in, line)) {
+		// the spaces are ignored
+		string assignment;
+		for (char c : line) {
+			if (not isspace(static_cast<unsigned char>(c))) {
+				assignment += c;
+			}
+		}
+
+		if (not assignment.empty() and assignment[0] != '#' and not set(assignment)) {
+			cerr << "Invalid parameter " << line << endl;
+			valid = false;
+		}
+	}
+	return valid;
+}
+//----------------------------------------------------------------------
+bool Parameters::read(const string& path)
+{
+	ifstream file(path);
+	if (not file) {
+		return false;
+	}
+	return read(file);
+}
+//----------------------------------------------------------------------
+bool Parameters::parse(int argc, char** argv, vector<string>& arguments)
+{
+	bool valid(true);
+	
+	for (int i(1); i < argc; ++i) {
+		string argument(argv[i]);
+		
+		if (argument.find('=') == string::npos) {
+			arguments.push_back(argument);
+			
+		} else if (argument.compare(0, 7, "config=") == 0) {
+			ifstream file(argument.substr(7));
+			if (not file) {
+				cerr << "Error opening file " << argument.substr(7) << endl;
+				valid = false;
+			} else if (not read(file)) {
+				valid = false;
+			}
+			
+		} else if (not set(argument)) {
+			cerr << "Invalid parameter " << argument << endl;
+			valid = false;
+		}
+	}
+	return valid;
+}
+//----------------------------------------------------------------------
+void Parameters::write(ostream& out) const
+{
+	// enough digits for the values to be read back unchanged (0.1 is still written 0.1)
+	streamsize precision = out.precision(15);
+	for (const auto& parameter : Names) {
+		out << parameter.name << " = " << this->*parameter.value << '\n';
+	}
+	out.precision(precision);
+}
+//======================================================================
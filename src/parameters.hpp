@@ -0,0 +1,118 @@
+#ifndef parameters_H
+#define parameters_H
+#include <string>
+#include <iosfwd>
+#include <vector>
+#include "constants.hpp"
+#include "kernel.hpp"
+
+/**
+ * @brief Parameters of Brunel's model, chosen at runtime.
+ *
+ * The default values are the constants of constants.hpp (graph C of figure 8).
+ * A parameter is named as its constant: g, Eta, Threshold, PotentialReset, dt, Resistance, Capacity,
+ * tauRp, Amplitude, Delay and ConnectionPercent.
+ * The parameters are given by assignments "name=value", on the command line or in a configuration file
+ * (one assignment per line, the lines starting with # are comments).
+ *
+ * @note When the parameters of the membrane are the default ones, the neurons are updated by kernels
+ * compiled with the constants of constants.hpp (see getMembraneKernel).
+ */
+struct Parameters {
+	double g = ::g; //!< Relative strength of inhibitory synapses
+	double eta = Eta; //!< External frequency relative to the threshold frequency
+	double threshold = Threshold; //!< Maximum potential limit [mV]
+	double potentialReset = PotentialReset; //!< Potential reset [mV]
+	double dt = ::dt; //!< Time variation [ms]
+	double resistance = Resistance; //!< Membrane Resistance [Ohm]
+	double capacity = Capacity; //!< Capacity [Farrad]
+	double tauRp = ::tauRp; //!< Refractory time period [ms]
+	double amplitude = Amplitude; //!< Spike Amplitude received from excitatory neurons
+	double delay = Delay; //!< Transmission delay [ms]
+	double connectionPercent = ConnectionPercent; //!< Connections pourcentage in the whole network
+
+	/**
+	 * @brief Get the membrane time constant tau = Resistance * Capacity.
+	 */
+	double getTau() const;
+
+	/**
+	 * @brief Get the decay of the potential during a step, e = exp(-dt/tau).
+	 */
+	double getDecay() const;
+
+	/**
+	 * @brief Get the external frequency Vext = Threshold * Eta / (Amplitude * tau).
+	 */
+	double getExternalFrequency() const;
+
+	/**
+	 * @brief Get the transmission delay in steps (rounded to the nearest step).
+	 */
+	unsigned int getDelaySteps() const;
+
+	/**
+	 * @brief Get the refractory period in steps (rounded to the nearest step).
+	 */
+	unsigned int getRefractorySteps() const;
+
+	/**
+	 * @brief Get the parameters of the membrane equation read by the membrane kernel.
+	 */
+	MembraneConstants getMembraneConstants() const;
+
+	/**
+	 * @brief Whether the parameters describe a network that can be simulated.
+	 *
+	 * The step time, the membrane and the amplitude must be positive, the delay must last at least one step
+	 * and the percentage of connections must be in [0, 1].
+	 */
+	bool isValid() const;
+
+	/**
+	 * @brief Set a parameter from its name.
+	 *
+	 * @return whether the parameter exists
+	 */
+	bool set(const std::string& name, double value);
+
+	/**
+	 * @brief Set a parameter from an assignment "name=value".
+	 *
+	 * @return whether the assignment is valid and the parameter exists
+	 */
+	bool set(const std::string& assignment);
+
+	/**
+	 * @brief Read the assignments of a configuration file.
+	 *
+	 * @return whether every assignment is valid (the valid ones are made anyway)
+	 */
+	bool read(std::istream& in);
+
+	/**
+	 * @brief Read the assignments of a configuration file.
+	 *
+	 * @return whether the file could be opened and every assignment is valid
+	 */
+	bool read(const std::string& path);
+
+	/**
+	 * @brief Read the assignments of the command line.
+	 *
+	 * An argument "name=value" sets a parameter, "config=path" reads a configuration file.
+	 * The assignments can be anywhere on the command line, the other arguments are kept in order.
+	 *
+	 * @param arguments receives the arguments which are not assignments (argv[0] excluded)
+	 *
+	 * @return whether every assignment is valid
+	 */
+	bool parse(int argc, char** argv, std::vector<std::string>& arguments);
+
+	/**
+	 * @brief Write all the parameters as a configuration file.
+	 */
+	void write(std::ostream& out) const;
+};
+
+#endif
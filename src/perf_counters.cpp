@@ -0,0 +1,165 @@
+#include "perf_counters.hpp"
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//======================================================================
+string getName(Counter counter)
+{
+	static const char* Names[NbCounters] = { "cycles", "instructions", "cache-references", "cache-misses",
+	                                         "branches", "branch-misses", "page-faults" };
+	return Names[static_cast<unsigned int>(counter)];
+}
+//======================================================================
+//constructeur/destructeur
+PerfCounters::PerfCounters()
+: nbOpen_(0), thread_(0)
+{
+	for (auto& descriptor : descriptors_) {
+		descriptor = -1;
+	}
+}
+//----------------------------------------------------------------------
+PerfCounters::~PerfCounters()
+{
+	close();
+}
+//======================================================================
+bool PerfCounters::open()
+{
+	close();
+
+#ifdef __linux__
+	static const struct {
+		uint32_t type;
+		uint64_t config;
+	} Events[NbCounters] = {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+	};
+
+	int leader(-1);
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = Events[c].type;
+		attributes.config = Events[c].config;
+		attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attributes.disabled = (leader < 0);
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+
+		// calling thread, any processor; a counter that cannot be opened is left out
+		int descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0);
+		if (descriptor >= 0) {
+			descriptors_[c] = descriptor;
+			leader = (leader < 0) ? descriptor : leader;
+			++nbOpen_;
+		}
+	}
+
+	if (leader >= 0) {
+		thread_ = getCurrentThread();
+		ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		
+		// an enabled group runs at once on the calling thread, unless its hardware counters are all taken
+		uint64_t values[NbCounters];
+		if (not read(values)) {
+			close();
+		}
+	}
+#endif
+	return isOpen();
+}
+//----------------------------------------------------------------------
+void PerfCounters::close()
+{
+#ifdef __linux__
+	// the members of the group before its leader
+	for (int c(NbCounters - 1); c >= 0; --c) {
+		if (descriptors_[c] >= 0) {
+			::close(descriptors_[c]);
+		}
+	}
+#endif
+	for (auto& descriptor : descriptors_) {
+		descriptor = -1;
+	}
+	nbOpen_ = 0;
+	thread_ = 0;
+}
+//----------------------------------------------------------------------
+bool PerfCounters::isOpen() const
+{
+	return nbOpen_ > 0;
+}
+//----------------------------------------------------------------------
+bool PerfCounters::isAvailable(Counter counter) const
+{
+	return descriptors_[static_cast<unsigned int>(counter)] >= 0;
+}
+//----------------------------------------------------------------------
+long PerfCounters::getThread() const
+{
+	return thread_;
+}
+//----------------------------------------------------------------------
+long PerfCounters::getCurrentThread()
+{
+#ifdef __linux__
+	return syscall(SYS_gettid);
+#else
+	return 0;
+#endif
+}
+//----------------------------------------------------------------------
+bool PerfCounters::read(uint64_t values[NbCounters]) const
+{
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		values[c] = 0;
+	}
+	if (not isOpen()) {
+		return false;
+	}
+
+#ifdef __linux__
+	// the group is read at once: number of counters, times enabled and running, then the values in order of opening
+	uint64_t group[NbCounters + 3];
+	int leader(-1);
+	for (unsigned int c(0); c < NbCounters and leader < 0; ++c) {
+		leader = descriptors_[c];
+	}
+	if (::read(leader, group, sizeof(group)) < static_cast<ssize_t>((nbOpen_ + 3)*sizeof(uint64_t)) or group[0] != nbOpen_) {
+		return false;
+	}
+
+	// a group which never ran has counted nothing: its 0 are not measures
+	if (group[2] == 0) {
+		return false;
+	}
+
+	unsigned int next(3);
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		if (descriptors_[c] >= 0) {
+			values[c] = group[next++];
+		}
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+//======================================================================
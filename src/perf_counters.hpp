@@ -0,0 +1,102 @@
+#ifndef perf_counters_H
+#define perf_counters_H
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Events counted by the performance counters of the processor.
+ */
+enum class Counter : unsigned int {
+	Cycles, //!< Cycles of the processor
+	Instructions, //!< Instructions retired
+	CacheReferences, //!< Accesses to the last level cache
+	CacheMisses, //!< Misses of the last level cache
+	Branches, //!< Branch instructions retired
+	BranchMisses, //!< Mispredicted branches
+	PageFaults //!< Page faults (software counter of the kernel)
+};
+
+const unsigned int NbCounters = 7; //!< Number of counters
+
+/**
+ * @brief Get the name of a counter.
+ */
+std::string getName(Counter counter);
+
+/*!
+ * @class PerfCounters
+ *
+ * @brief Performance counters of the calling thread, read with the Linux perf_event_open interface.
+ *
+ * The counters are opened as one group, so they count during the same intervals, and only in user mode.
+ * A counter that the processor or the kernel does not provide (virtual machine, perf_event_paranoid above 2,
+ * another system than Linux) is left out: the others are still counted, and read as 0 when none could be opened.
+ * A group that the kernel never schedules on the processor (its hardware counters are all taken) is not open.
+ */
+class PerfCounters {
+
+public:
+	/**
+	 * @brief Constructor: no counter is open.
+	 */
+	PerfCounters();
+
+	/**
+	 * @brief Destructor: closes the counters.
+	 */
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	/**
+	 * @brief Open the counters of the calling thread and start them.
+	 *
+	 * @return whether at least one counter could be opened
+	 */
+	bool open();
+
+	/**
+	 * @brief Close the counters.
+	 */
+	void close();
+
+	/**
+	 * @brief Whether at least one counter is open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Whether a counter is open.
+	 */
+	bool isAvailable(Counter counter) const;
+
+	/**
+	 * @brief Get the kernel identifier of the thread which opened the counters (0 if they are not open).
+	 */
+	long getThread() const;
+
+	/**
+	 * @brief Get the kernel identifier of the calling thread (0 on another system than Linux).
+	 *
+	 * @note Unlike std::thread::id, it is not given again to a new thread as soon as the previous one ends.
+	 */
+	static long getCurrentThread();
+
+	/**
+	 * @brief Read the values of the counters since they were opened (0 for the counters which are not open).
+	 *
+	 * @return whether the counters could be read, false when the group has not been scheduled since it was opened
+	 */
+	bool read(uint64_t values[NbCounters]) const;
+
+private:
+
+	int descriptors_[NbCounters]; //!< File descriptor of each counter (-1 if not open), the first open one leads the group
+
+	unsigned int nbOpen_; //!< Number of counters open
+
+	long thread_; //!< Kernel identifier of the thread which opened the counters (0 if none is open)
+};
+
+#endif
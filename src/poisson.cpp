@@ -0,0 +1,99 @@
+#include "poisson.hpp"
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+
+//======================================================================
+//constructeurs/destructeurs
+PoissonGenerator::PoissonGenerator(double mean)
+: mean_(mean)
+{
+	// cumulative distribution function, P(X = k) = P(X = k-1) * mean / k
+	double p = exp(-mean_);
+	double cumulative = p;
+	unsigned int k(0);
+
+	while (p > 0.0) {
+		double threshold = ceil(cumulative*4294967296.0);
+		if (threshold >= 4294967296.0) {
+			break;
+		}
+		thresholds_.push_back(static_cast<uint32_t>(threshold));
+
+		++k;
+		p *= mean_/k;
+		cumulative += p;
+	}
+}
+//======================================================================
+double PoissonGenerator::getMean() const
+{
+	return mean_;
+}
+//======================================================================
+//Draw of one number of spikes
+unsigned int PoissonGenerator::draw(uint32_t random) const
+{
+	unsigned int k(0);
+	for (auto threshold : thresholds_) {
+		k += (random >= threshold);
+	}
+	return k;
+}
+//----------------------------------------------------------------------
+unsigned int PoissonGenerator::draw(const Philox::Key& key, uint32_t stream, unsigned int neuron, unsigned long step) const
+{
+	// one random number per neuron and per step: the four numbers of a counter go to four neurons
+	Philox::Counter counter = {{ neuron/4, static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32), stream }};
+	return draw(Philox::generate(counter, key)[neuron % 4]);
+}
+//======================================================================
+//Draw in bulk
+void PoissonGenerator::fill(const Philox::Key& key, uint32_t stream, unsigned long step,
+                            unsigned int begin, unsigned int end, double* slot) const
+{
+	assert(begin % 4 == 0);
+
+	uint32_t random[ChunkSize];
+	uint32_t count[ChunkSize];
+
+	for (unsigned int first(begin); first < end; first += ChunkSize) {
+		unsigned int size = min(ChunkSize, end - first);
+
+		// random numbers of the chunk, four neurons per counter
+		for (unsigned int j(0); j < size; j += 4) {
+			Philox::Counter counter = {{ (first + j)/4, static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32), stream }};
+			counter = Philox::generate(counter, key);
+			copy(counter.begin(), counter.begin() + min(4u, size - j), random + j);
+		}
+
+		// inversion: for each threshold, all the neurons of the chunk are compared at once
+		fill_n(count, size, 0);
+		for (auto threshold : thresholds_) {
+			for (unsigned int j(0); j < size; ++j) {
+				count[j] += (random[j] >= threshold);
+			}
+		}
+
+		for (unsigned int j(0); j < size; ++j) {
+			slot[first + j] += count[j];
+		}
+	}
+}
+//----------------------------------------------------------------------
+void PoissonGenerator::fill(const Philox::Key& key, uint32_t stream, unsigned long firstStep, unsigned int nbSteps,
+                            unsigned int begin, unsigned int end, double* const* slots) const
+{
+	for (unsigned int s(0); s < nbSteps; ++s) {
+		fill(key, stream, firstStep + s, begin, end, slots[s]);
+	}
+}
+//======================================================================
+//Memory
+void PoissonGenerator::reportMemory(MemoryReport& report) const
+{
+	report.add("random numbers", thresholds_);
+}
+//======================================================================
@@ -0,0 +1,95 @@
+#ifndef poisson_H
+#define poisson_H
+#include <vector>
+#include <cstdint>
+#include "random.hpp"
+#include "memory_report.hpp"
+
+/*!
+ * @class PoissonGenerator
+ *
+ * @brief Poisson distribution of fixed mean, drawn by inversion of a table.
+ *
+ * The cumulative distribution function is stored once as a table of 32 bits thresholds:
+ * a 32 bits random number x gives k external spikes where k is the number of thresholds lower or equal to x.
+ * The count is made without branch, so the external spikes of many neurons can be drawn together
+ * (the loops are vectorized by the compiler).
+ *
+ * The random numbers come from the counter-based generator Philox with the counter (neuron/4, step, stream):
+ * the external spikes of a neuron at a step are the same whether they are drawn alone or in bulk.
+ */
+class PoissonGenerator {
+
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param mean is the mean of the distribution (dt*Vext for the external spikes)
+	 */
+	PoissonGenerator(double mean = 0.0);
+
+	/**
+	 * @brief Get the mean of the distribution.
+	 */
+	double getMean() const;
+
+	/**
+	 * @brief Add the memory of the table of the distribution ("random numbers") to a report.
+	 */
+	void reportMemory(MemoryReport& report) const;
+
+	/**
+	 * @brief Draw the number of spikes corresponding to a 32 bits random number.
+	 */
+	unsigned int draw(uint32_t random) const;
+
+	/**
+	 * @brief Draw the number of spikes of one neuron at one step.
+	 *
+	 * @param key is the key of the counter-based generator
+	 * @param stream identifies the random numbers of the external spikes
+	 * @param neuron is the neuron receiving the spikes
+	 * @param step is the step time of the spikes
+	 */
+	unsigned int draw(const Philox::Key& key, uint32_t stream, unsigned int neuron, unsigned long step) const;
+
+	/**
+	 * @brief Draw the spikes of the neurons of [begin, end) at one step and add them to a slot of the delay ring.
+	 *
+	 * @param key is the key of the counter-based generator
+	 * @param stream identifies the random numbers of the external spikes
+	 * @param step is the step time of the spikes
+	 * @param begin is the first neuron (multiple of 4)
+	 * @param end is the neuron following the last neuron
+	 * @param slot is the slot of the delay ring (one entry per neuron of the population)
+	 */
+	void fill(const Philox::Key& key, uint32_t stream, unsigned long step,
+	          unsigned int begin, unsigned int end, double* slot) const;
+
+	/**
+	 * @brief Draw the spikes of the neurons of [begin, end) for a window of steps.
+	 *
+	 * The spikes of step firstStep + s are added to slots[s].
+	 *
+	 * @param nbSteps is the number of steps of the window
+	 * @param slots are the slots of the delay ring receiving the spikes of each step
+	 */
+	void fill(const Philox::Key& key, uint32_t stream, unsigned long firstStep, unsigned int nbSteps,
+	          unsigned int begin, unsigned int end, double* const* slots) const;
+
+private:
+
+	double mean_; //!< Mean of the distribution
+
+	/**
+	 * @brief Thresholds of the cumulative distribution function
+	 *
+	 * thresholds_[k] is the smallest 32 bits number x such that x / 2^32 >= P(X <= k).
+	 * The table ends when the threshold does not fit anymore in 32 bits.
+	 */
+	std::vector<uint32_t> thresholds_;
+
+	static const unsigned int ChunkSize = 256; //!< Number of neurons drawn together
+};
+
+#endif
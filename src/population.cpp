@@ -0,0 +1,232 @@
+#include "population.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+//======================================================================
+//constructeurs/destructeurs
+NeuronPopulation::NeuronPopulation(unsigned int size, unsigned int nbSlots)
+: size_(size), nbSlots_(nbSlots),
+  potential_(size, 0.0), refractoryTime_(size, 0), iext_(size, 0.0),
+  nbSpikes_(size, 0), spikeMask_((size+63)/64, 0), isInhibiter_(size, 0),
+  buffer_(static_cast<size_t>(size)*nbSlots, 0.0), constants_(getDefaultConstants())
+{
+	setKernel(bestKernel());
+}
+//======================================================================
+//Getters
+unsigned int NeuronPopulation::size() const
+{
+	return size_;
+}
+//----------------------------------------------------------------------
+unsigned int NeuronPopulation::getNbSlots() const
+{
+	return nbSlots_;
+}
+//----------------------------------------------------------------------
+double NeuronPopulation::getPotential(unsigned int i) const
+{
+	return potential_[i];
+}
+//----------------------------------------------------------------------
+unsigned int NeuronPopulation::getNbSpikes(unsigned int i) const
+{
+	return nbSpikes_[i];
+}
+//----------------------------------------------------------------------
+int NeuronPopulation::getRefractoryTime(unsigned int i) const
+{
+	return refractoryTime_[i];
+}
+//----------------------------------------------------------------------
+double NeuronPopulation::getIext(unsigned int i) const
+{
+	return iext_[i];
+}
+//----------------------------------------------------------------------
+bool NeuronPopulation::hasSpike(unsigned int i) const
+{
+	return (spikeMask_[i/64] >> (i%64)) & 1;
+}
+//----------------------------------------------------------------------
+const uint64_t* NeuronPopulation::getSpikeMask() const
+{
+	return spikeMask_.data();
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::collectSpikes(unsigned int begin, unsigned int end, vector<unsigned int>& spikes) const
+{
+	assert(begin % 64 == 0);
+	
+	for (unsigned int word(begin/64); word*64 < end; ++word) {
+		uint64_t mask = spikeMask_[word];
+		
+		while (mask != 0) {
+			spikes.push_back(word*64 + __builtin_ctzll(mask));
+			mask &= mask - 1;
+		}
+	}
+}
+//----------------------------------------------------------------------
+bool NeuronPopulation::isInhibiter(unsigned int i) const
+{
+	return isInhibiter_[i];
+}
+//----------------------------------------------------------------------
+double NeuronPopulation::getBuffer(unsigned int i, size_t slot) const
+{
+	return buffer_[slot*size_ + i];
+}
+//======================================================================
+//Setters
+void NeuronPopulation::setPotential(unsigned int i, double potential)
+{
+	potential_[i] = potential;
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::setIext(unsigned int i, double iext)
+{
+	iext_[i] = iext;
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::setIsInhibiter(unsigned int i, bool type)
+{
+	isInhibiter_[i] = type;
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::copyNeuron(unsigned int j, const NeuronPopulation& source, unsigned int i)
+{
+	assert(nbSlots_ == source.nbSlots_);
+
+	potential_[j] = source.potential_[i];
+	refractoryTime_[j] = source.refractoryTime_[i];
+	iext_[j] = source.iext_[i];
+	nbSpikes_[j] = source.nbSpikes_[i];
+	spikeMask_[j/64] &= ~(uint64_t(1) << (j%64));
+	spikeMask_[j/64] |= uint64_t(source.hasSpike(i)) << (j%64);
+	isInhibiter_[j] = source.isInhibiter_[i];
+
+	for (size_t s(0); s < nbSlots_; ++s) {
+		buffer_[s*size_ + j] = source.buffer_[s*source.size_ + i];
+	}
+}
+//======================================================================
+//Membrane equation : temporal evolution of the membrane potential
+double NeuronPopulation::membraneEq(unsigned int i, size_t readBox) const
+{
+	return constants_.decay*potential_[i] + iext_[i]*constants_.resistance*constants_.oneMinusDecay
+	       + buffer_[readBox*size_ + i]*constants_.amplitude;
+}
+//======================================================================
+//update du potentiel
+void NeuronPopulation::update(unsigned int i, size_t readBox)
+{
+	update(i, i+1, readBox);
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::update(unsigned int begin, unsigned int end, size_t readBox)
+{
+	assert(end <= size_);
+
+	MembraneArrays arrays = { potential_.data(), refractoryTime_.data(), iext_.data(),
+	                          buffer_.data() + readBox*size_, spikeMask_.data(), nbSpikes_.data() };
+	membraneKernel_(arrays, constants_, begin, end);
+}
+//----------------------------------------------------------------------
+Kernel NeuronPopulation::getKernel() const
+{
+	return kernel_;
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::setKernel(Kernel kernel)
+{
+	assert(isSupported(kernel));
+	
+	kernel_ = kernel;
+	membraneKernel_ = getMembraneKernel(kernel, constants_);
+}
+//----------------------------------------------------------------------
+const MembraneConstants& NeuronPopulation::getConstants() const
+{
+	return constants_;
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::setConstants(const MembraneConstants& constants)
+{
+	constants_ = constants;
+	
+	// the kernel is compiled either with the default constants or for any constants
+	setKernel(kernel_);
+}
+//======================================================================
+// Gestion du buffer
+void NeuronPopulation::fillBuffer(unsigned int i, double spike, size_t writeBox)
+{
+	buffer_[writeBox*size_ + i] += spike;
+}
+//----------------------------------------------------------------------
+double* NeuronPopulation::slot(size_t slot)
+{
+	return buffer_.data() + slot*size_;
+}
+//----------------------------------------------------------------------
+void NeuronPopulation::clearSlot(size_t slot, unsigned int begin, unsigned int end)
+{
+	fill(buffer_.begin() + slot*size_ + begin, buffer_.begin() + slot*size_ + end, 0.0);
+}
+//======================================================================
+//Snapshot
+void NeuronPopulation::save(ostream& out) const
+{
+	writeArray(out, potential_);
+	writeArray(out, refractoryTime_);
+	writeArray(out, iext_);
+	writeArray(out, nbSpikes_);
+	writeArray(out, spikeMask_);
+	writeArray(out, isInhibiter_);
+	writeArray(out, buffer_);
+}
+//----------------------------------------------------------------------
+bool NeuronPopulation::restore(istream& in)
+{
+	// read aside: the population is only changed if the whole state is valid
+	NeuronPopulation state(size_, nbSlots_);
+	
+	if (not (readArray(in, state.potential_, size_) and readArray(in, state.refractoryTime_, size_)
+	         and readArray(in, state.iext_, size_) and readArray(in, state.nbSpikes_, size_)
+	         and readArray(in, state.spikeMask_, spikeMask_.size()) and readArray(in, state.isInhibiter_, size_)
+	         and readArray(in, state.buffer_, buffer_.size()))) {
+		return false;
+	}
+	
+	if (state.potential_.size() != size_ or state.refractoryTime_.size() != size_ or state.iext_.size() != size_
+	    or state.nbSpikes_.size() != size_ or state.spikeMask_.size() != spikeMask_.size()
+	    or state.isInhibiter_.size() != size_ or state.buffer_.size() != buffer_.size()) {
+		return false;
+	}
+	
+	potential_.swap(state.potential_);
+	refractoryTime_.swap(state.refractoryTime_);
+	iext_.swap(state.iext_);
+	nbSpikes_.swap(state.nbSpikes_);
+	spikeMask_.swap(state.spikeMask_);
+	isInhibiter_.swap(state.isInhibiter_);
+	buffer_.swap(state.buffer_);
+	return true;
+}
+//======================================================================
+//Memory
+void NeuronPopulation::reportMemory(MemoryReport& report) const
+{
+	report.add("neurons", potential_);
+	report.add("neurons", refractoryTime_);
+	report.add("neurons", iext_);
+	report.add("neurons", nbSpikes_);
+	report.add("neurons", spikeMask_);
+	report.add("neurons", isInhibiter_);
+	report.add("delay ring", buffer_);
+}
+//======================================================================
@@ -0,0 +1,238 @@
+#ifndef population_H
+#define population_H
+#include <vector>
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include "constants.hpp"
+#include "kernel.hpp"
+#include "memory_report.hpp"
+
+/*!
+ * @class NeuronPopulation
+ *
+ * @brief Structure of arrays holding the state of a whole population of neurons.
+ *
+ * Instead of one heap object per neuron, each state variable (potential, refractory timer,
+ * type, spike flag...) is stored in its own contiguous array indexed by the neuron number.
+ * The transmission delay ring of every neuron is held as one [slot][neuron] matrix:
+ * all the neurons read (or write) the same slot at a given step, so a slot is a contiguous row.
+ *
+ * @note A Neuron object is a thin view on one entry of a population.
+ */
+class NeuronPopulation {
+
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param size is the number of neurons of the population
+	 * @param nbSlots is the number of slots of the delay ring. Default value = DelayStep + 1
+	 */
+	NeuronPopulation(unsigned int size = 0, unsigned int nbSlots = DelayStep+1);
+
+	/**
+	 * @brief Get the number of neurons of the population.
+	 */
+	unsigned int size() const;
+
+	/**
+	 * @brief Get the number of slots of the delay ring.
+	 */
+	unsigned int getNbSlots() const;
+
+	/**
+	 * @brief Get the potential of neuron i.
+	 */
+	double getPotential(unsigned int i) const;
+
+	/**
+	 * @brief Get the number of spikes of neuron i.
+	 */
+	unsigned int getNbSpikes(unsigned int i) const;
+
+	/**
+	 * @brief Get the refractory time of neuron i.
+	 */
+	int getRefractoryTime(unsigned int i) const;
+
+	/**
+	 * @brief Get the external current of neuron i.
+	 */
+	double getIext(unsigned int i) const;
+
+	/**
+	 * @brief Whether neuron i spiked during its last update.
+	 */
+	bool hasSpike(unsigned int i) const;
+
+	/**
+	 * @brief Get the spike mask of the population.
+	 *
+	 * @return the words of the mask: bit i%64 of word i/64 is set if neuron i spiked during its last update
+	 */
+	const uint64_t* getSpikeMask() const;
+
+	/**
+	 * @brief List the neurons of [begin, end) that spiked during their last update.
+	 *
+	 * The spike mask is read word by word: the words without spike (most of them) are skipped
+	 * and the set bits of the other words are extracted one by one.
+	 *
+	 * @param begin is the first neuron (multiple of 64)
+	 * @param end is the neuron following the last neuron
+	 * @param spikes receives the indexes of the spiking neurons, in increasing order (appended)
+	 */
+	void collectSpikes(unsigned int begin, unsigned int end, std::vector<unsigned int>& spikes) const;
+
+	/**
+	 * @brief Get the type of neuron i.
+	 *
+	 * @return is inhibiter or is excitatory
+	 */
+	bool isInhibiter(unsigned int i) const;
+
+	/**
+	 * @brief Get the content of the delay ring of neuron i at the given slot.
+	 */
+	double getBuffer(unsigned int i, size_t slot) const;
+
+	/**
+	 * @brief Set the potential of neuron i.
+	 */
+	void setPotential(unsigned int i, double potential);
+
+	/**
+	 * @brief Set the external current of neuron i.
+	 */
+	void setIext(unsigned int i, double iext);
+
+	/**
+	 * @brief Set the type of neuron i.
+	 */
+	void setIsInhibiter(unsigned int i, bool type);
+
+	/**
+	 * @brief Copy the whole state of neuron i of the population source into neuron j.
+	 *
+	 * @note Used to attach (and detach) Neuron views to the population of a network.
+	 */
+	void copyNeuron(unsigned int j, const NeuronPopulation& source, unsigned int i);
+
+	/**
+	 * @brief Membrane equation of neuron i (see Neuron::membraneEq).
+	 */
+	double membraneEq(unsigned int i, size_t readBox) const;
+
+	/**
+	 * @brief Update neuron i (see Neuron::update).
+	 */
+	void update(unsigned int i, size_t readBox);
+
+	/**
+	 * @brief Update the neurons of the range [begin, end).
+	 *
+	 * The neurons are updated by the membrane kernel of the population (see setKernel).
+	 *
+	 * @param readBox is the slot of the delay ring read in the membrane equation
+	 */
+	void update(unsigned int begin, unsigned int end, size_t readBox);
+
+	/**
+	 * @brief Get the kernel updating the neurons.
+	 */
+	Kernel getKernel() const;
+
+	/**
+	 * @brief Set the kernel updating the neurons.
+	 *
+	 * By default, the fastest kernel supported by the processor is chosen at runtime.
+	 *
+	 * @param kernel is a kernel supported by the processor
+	 */
+	void setKernel(Kernel kernel);
+
+	/**
+	 * @brief Get the parameters of the membrane equation of the neurons.
+	 */
+	const MembraneConstants& getConstants() const;
+
+	/**
+	 * @brief Set the parameters of the membrane equation of the neurons.
+	 *
+	 * By default, the parameters are the constants of constants.hpp.
+	 * The kernel is compiled with the constants of constants.hpp as long as they are not changed (see getMembraneKernel).
+	 */
+	void setConstants(const MembraneConstants& constants);
+
+	/**
+	 * @brief Record a spike received by neuron i into the delay ring.
+	 */
+	void fillBuffer(unsigned int i, double spike, size_t writeBox);
+
+	/**
+	 * @brief Get the row of the delay ring corresponding to slot.
+	 *
+	 * @return pointer to the size() entries of the slot (one per neuron)
+	 */
+	double* slot(size_t slot);
+
+	/**
+	 * @brief Empty the slot of the delay ring for the neurons of the range [begin, end).
+	 */
+	void clearSlot(size_t slot, unsigned int begin, unsigned int end);
+
+	/**
+	 * @brief Write the state of all the neurons into a snapshot (see snapshot.hpp).
+	 */
+	void save(std::ostream& out) const;
+
+	/**
+	 * @brief Read the state of all the neurons from a snapshot.
+	 *
+	 * @return whether the state could be read (the population of the snapshot must have the same size and number of slots)
+	 *
+	 * @note The population is unchanged if the state could not be read.
+	 */
+	bool restore(std::istream& in);
+
+	/**
+	 * @brief Add the memory of the state of the neurons ("neurons") and of the delay ring ("delay ring") to a report.
+	 */
+	void reportMemory(MemoryReport& report) const;
+
+private:
+
+	unsigned int size_; //!< Number of neurons
+
+	unsigned int nbSlots_; //!< Number of slots of the delay ring
+
+	std::vector<double> potential_; //!< Membrane potential of each neuron
+
+	std::vector<int> refractoryTime_; //!< Refractory timer of each neuron
+
+	std::vector<double> iext_; //!< External current of each neuron
+
+	std::vector<unsigned int> nbSpikes_; //!< Number of spikes of each neuron
+
+	std::vector<uint64_t> spikeMask_; //!< Spike state of each neuron: one bit per neuron
+
+	std::vector<unsigned char> isInhibiter_; //!< Type of each neuron: 1 if inhibiter, 0 if excitatory
+
+	/**
+	 * @brief Delay ring of the population
+	 *
+	 * Matrix [slot][neuron] stored row by row: the entry of neuron i at slot s is buffer_[s*size_ + i].
+	 *
+	 * @note The ring holds doubles so that a non integer relative strength g is not truncated.
+	 */
+	std::vector<double> buffer_;
+
+	Kernel kernel_; //!< Instruction set of the membrane kernel
+
+	MembraneConstants constants_; //!< Parameters of the membrane equation
+
+	MembraneKernel membraneKernel_; //!< Function of the membrane kernel
+};
+
+#endif
@@ -0,0 +1,375 @@
+#include "profiler.hpp"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+
+const bool Profiler::Enabled;
+
+//======================================================================
+string getName(Phase phase)
+{
+	static const char* Names[NbPhases] = { "Connect", "Update", "Membrane", "External", "Collect",
+	                                       "Gather", "Delivery", "Record", "Checkpoint", "Output" };
+	return Names[static_cast<unsigned int>(phase)];
+}
+//----------------------------------------------------------------------
+//Phases summed over the window, recorded with their Update event
+static bool isInner(Phase phase)
+{
+	return phase == Phase::Membrane or phase == Phase::External or phase == Phase::Collect;
+}
+//======================================================================
+//constructeurs
+Profiler::ThreadEvents::ThreadEvents()
+: nbOpenings(0)
+{
+	clearInner();
+}
+//----------------------------------------------------------------------
+void Profiler::ThreadEvents::clearInner()
+{
+	fill(inner, inner + NbPhases, 0);
+	fill(nbInner, nbInner + NbPhases, 0);
+	for (auto& phaseCounters : innerCounters) {
+		fill(phaseCounters, phaseCounters + NbCounters, 0);
+	}
+}
+//----------------------------------------------------------------------
+Profiler::Profiler()
+: origin_(Clock::now()), window_(0), counters_(false)
+{
+	fill(available_, available_ + NbCounters, false);
+	setNbThreads(1);
+}
+//----------------------------------------------------------------------
+void Profiler::setNbThreads(unsigned int nbThreads)
+{
+	if (nbThreads > threads_.size()) {
+		threads_.resize(nbThreads);
+	}
+	for (ThreadEvents& events : threads_) {
+		events.counters.reset();
+	}
+}
+//----------------------------------------------------------------------
+unsigned int Profiler::getNbThreads() const
+{
+	return threads_.size();
+}
+//----------------------------------------------------------------------
+void Profiler::nextWindow()
+{
+	++window_;
+}
+//----------------------------------------------------------------------
+unsigned int Profiler::getNbWindows() const
+{
+	return window_;
+}
+//======================================================================
+//Performance counters
+bool Profiler::setCounters(bool enabled)
+{
+	// the calling thread tries the counters: the other threads get the same ones
+	PerfCounters probe;
+	counters_ = enabled and probe.open();
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		available_[c] = counters_ and probe.isAvailable(static_cast<Counter>(c));
+	}
+	return counters_;
+}
+//----------------------------------------------------------------------
+bool Profiler::hasCounters() const
+{
+	return counters_;
+}
+//----------------------------------------------------------------------
+bool Profiler::isAvailable(Counter counter) const
+{
+	return available_[static_cast<unsigned int>(counter)];
+}
+//----------------------------------------------------------------------
+unsigned long Profiler::readCounters(unsigned int thread, uint64_t values[NbCounters])
+{
+	ThreadEvents& events = threads_[thread];
+	
+	// a counter only counts the thread which opened it
+	if (not events.counters or events.counters->getThread() != PerfCounters::getCurrentThread()) {
+		events.counters.reset(new PerfCounters);
+		events.counters->open();
+		++events.nbOpenings;
+	}
+	return events.counters->read(values) ? events.nbOpenings : 0;
+}
+//======================================================================
+//Events
+void Profiler::record(unsigned int thread, Phase phase, Clock::time_point start, Clock::time_point stop, const uint64_t* counters)
+{
+	ThreadEvents& events = threads_[thread];
+	int64_t begin = chrono::duration_cast<chrono::nanoseconds>(start - origin_).count();
+	int64_t duration = chrono::duration_cast<chrono::nanoseconds>(stop - start).count();
+	unsigned int p = static_cast<unsigned int>(phase);
+
+	if (isInner(phase)) {
+		events.inner[p] += duration;
+		++events.nbInner[p];
+		for (unsigned int c(0); counters and c < NbCounters; ++c) {
+			events.innerCounters[p][c] += counters[c];
+		}
+		return;
+	}
+
+	// the phases inside the update, one after the other from its start
+	if (phase == Phase::Update) {
+		int64_t next = begin;
+		for (unsigned int inner(0); inner < NbPhases; ++inner) {
+			if (events.nbInner[inner] > 0) {
+				PhaseEvent event = { static_cast<Phase>(inner), window_, next, events.inner[inner], events.nbInner[inner], {} };
+				copy(events.innerCounters[inner], events.innerCounters[inner] + NbCounters, event.counters);
+				events.events.push_back(event);
+				next += events.inner[inner];
+			}
+		}
+		events.clearInner();
+	}
+
+	PhaseEvent event = { phase, window_, begin, duration, 1, {} };
+	if (counters) {
+		copy(counters, counters + NbCounters, event.counters);
+	}
+	events.events.push_back(event);
+}
+//----------------------------------------------------------------------
+const vector<PhaseEvent>& Profiler::getEvents(unsigned int thread) const
+{
+	return threads_[thread].events;
+}
+//----------------------------------------------------------------------
+double Profiler::getTotal(Phase phase) const
+{
+	int64_t total(0);
+	for (const auto& thread : threads_) {
+		for (const auto& event : thread.events) {
+			if (event.phase == phase) {
+				total += event.duration;
+			}
+		}
+	}
+	return total*1e-9;
+}
+//----------------------------------------------------------------------
+void Profiler::clear()
+{
+	for (auto& thread : threads_) {
+		thread.events.clear();
+		thread.clearInner();
+	}
+	window_ = 0;
+}
+//======================================================================
+//Reports
+void Profiler::writeSummary(ostream& out) const
+{
+	unsigned int nbThreads = threads_.size();
+
+	out << left << setw(12) << "phase" << right << setw(10) << "calls" << setw(12) << "total(ms)"
+	    << setw(14) << "window(us)" << setw(14) << "max(us)";
+	for (unsigned int t(0); t < nbThreads; ++t) {
+		out << setw(11) << "thread" << setw(3) << t;
+	}
+	out << '\n';
+
+	ios::fmtflags flags = out.flags();
+	streamsize precision = out.precision(3);
+	out << fixed;
+
+	for (unsigned int p(0); p < NbPhases; ++p) {
+		// time of each thread, in total and per window
+		unsigned long nbCalls(0);
+		vector<int64_t> threadTotals(nbThreads, 0);
+		vector<vector<int64_t> > windows(nbThreads, vector<int64_t>(window_ + 1, 0));
+		for (unsigned int t(0); t < nbThreads; ++t) {
+			for (const auto& event : threads_[t].events) {
+				if (static_cast<unsigned int>(event.phase) == p) {
+					nbCalls += event.count;
+					threadTotals[t] += event.duration;
+					windows[t][event.window] += event.duration;
+				}
+			}
+		}
+		if (nbCalls == 0) {
+			continue;
+		}
+
+		// a window waits for its slowest thread
+		int64_t total(0), sumSlowest(0), maxSlowest(0);
+		unsigned int nbWindows(0);
+		for (unsigned int w(0); w <= window_; ++w) {
+			int64_t slowest(0);
+			for (unsigned int t(0); t < nbThreads; ++t) {
+				slowest = max(slowest, windows[t][w]);
+			}
+			sumSlowest += slowest;
+			maxSlowest = max(maxSlowest, slowest);
+			nbWindows += slowest > 0;
+		}
+		for (auto threadTotal : threadTotals) {
+			total += threadTotal;
+		}
+
+		out << left << setw(12) << getName(static_cast<Phase>(p)) << right << setw(10) << nbCalls
+		    << setw(12) << total*1e-6 << setw(14) << sumSlowest*1e-3/max(1u, nbWindows) << setw(14) << maxSlowest*1e-3;
+		for (auto threadTotal : threadTotals) {
+			out << setw(14) << threadTotal*1e-6;
+		}
+		out << '\n';
+	}
+
+	if (counters_) {
+		writeCounters(out);
+	}
+
+	out.flags(flags);
+	out.precision(precision);
+}
+//----------------------------------------------------------------------
+void Profiler::writeCounters(ostream& out) const
+{
+	out << '\n' << left << setw(12) << "phase" << right << setw(8) << "IPC" << setw(12) << "cache-miss%"
+	    << setw(13) << "branch-miss%";
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		out << setw(18) << getName(static_cast<Counter>(c));
+	}
+	out << '\n';
+
+	for (unsigned int p(0); p < NbPhases; ++p) {
+		uint64_t totals[NbCounters] = {};
+		bool recorded(false);
+		for (const auto& thread : threads_) {
+			for (const auto& event : thread.events) {
+				if (static_cast<unsigned int>(event.phase) == p) {
+					recorded = true;
+					for (unsigned int c(0); c < NbCounters; ++c) {
+						totals[c] += event.counters[c];
+					}
+				}
+			}
+		}
+		if (not recorded) {
+			continue;
+		}
+
+		// a ratio is only given when both of its counters are available
+		auto ratio = [&](Counter numerator, Counter denominator, double scale, int width) {
+			unsigned int n = static_cast<unsigned int>(numerator), d = static_cast<unsigned int>(denominator);
+			if (isAvailable(numerator) and isAvailable(denominator) and totals[d] > 0) {
+				out << setw(width) << scale*totals[n]/totals[d];
+			} else {
+				out << setw(width) << "-";
+			}
+		};
+		out << left << setw(12) << getName(static_cast<Phase>(p)) << right;
+		ratio(Counter::Instructions, Counter::Cycles, 1.0, 8);
+		ratio(Counter::CacheMisses, Counter::CacheReferences, 100.0, 12);
+		ratio(Counter::BranchMisses, Counter::Branches, 100.0, 13);
+		for (unsigned int c(0); c < NbCounters; ++c) {
+			if (isAvailable(static_cast<Counter>(c))) {
+				out << setw(18) << totals[c];
+			} else {
+				out << setw(18) << "-";
+			}
+		}
+		out << '\n';
+	}
+}
+//----------------------------------------------------------------------
+void Profiler::writeTrace(ostream& out) const
+{
+	ios::fmtflags flags = out.flags();
+	streamsize precision = out.precision(3);
+	out << fixed;
+
+	// complete events ("X"), the times are in microseconds
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+	bool first(true);
+	for (unsigned int t(0); t < threads_.size(); ++t) {
+		out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << t
+		    << ", \"args\": {\"name\": \"thread " << t << "\"}}";
+		first = false;
+
+		for (const auto& event : threads_[t].events) {
+			out << ",\n{\"name\": \"" << getName(event.phase) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << t
+			    << ", \"ts\": " << event.start*1e-3 << ", \"dur\": " << event.duration*1e-3
+			    << ", \"args\": {\"window\": " << event.window << ", \"calls\": " << event.count;
+			for (unsigned int c(0); c < NbCounters; ++c) {
+				if (isAvailable(static_cast<Counter>(c))) {
+					out << ", \"" << getName(static_cast<Counter>(c)) << "\": " << event.counters[c];
+				}
+			}
+			out << "}}";
+		}
+	}
+	out << "\n]}\n";
+
+	out.flags(flags);
+	out.precision(precision);
+}
+//----------------------------------------------------------------------
+bool Profiler::writeTrace(const string& path) const
+{
+	ofstream file(path);
+	if (not file) {
+		return false;
+	}
+	writeTrace(file);
+	return bool(file);
+}
+//======================================================================
+//Timer of a phase
+PhaseTimer::PhaseTimer(Profiler& profiler, Phase phase, unsigned int thread)
+: profiler_(profiler), phase_(phase), thread_(thread), opening_(0)
+{
+	if (profiler_.hasCounters()) {
+		opening_ = profiler_.readCounters(thread_, counters_);
+	}
+	start_ = Profiler::Clock::now();
+}
+//----------------------------------------------------------------------
+PhaseTimer::~PhaseTimer()
+{
+	Profiler::Clock::time_point stop = Profiler::Clock::now();
+	if (not profiler_.hasCounters()) {
+		profiler_.record(thread_, phase_, start_, stop);
+		return;
+	}
+	
+	// the counters opened again during the phase do not give its events: only its time is recorded
+	uint64_t counters[NbCounters];
+	unsigned long opening = profiler_.readCounters(thread_, counters);
+	if (opening == 0 or opening != opening_) {
+		profiler_.record(thread_, phase_, start_, stop);
+		return;
+	}
+	for (unsigned int c(0); c < NbCounters; ++c) {
+		counters[c] -= counters_[c];
+	}
+	profiler_.record(thread_, phase_, start_, stop, counters);
+}
+//======================================================================
+//Memory
+size_t Profiler::getMemory(unsigned int nbThreads, size_t nbEvents)
+{
+	return nbThreads*(sizeof(ThreadEvents) + nbEvents*sizeof(PhaseEvent));
+}
+//----------------------------------------------------------------------
+void Profiler::reportMemory(MemoryReport& report) const
+{
+	report.add("profiler", threads_.size()*sizeof(ThreadEvents), threads_.capacity()*sizeof(ThreadEvents));
+	for (const auto& thread : threads_) {
+		report.add("profiler", thread.events);
+	}
+}
+//======================================================================
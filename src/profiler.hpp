@@ -0,0 +1,268 @@
+#ifndef profiler_H
+#define profiler_H
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include "perf_counters.hpp"
+#include "memory_report.hpp"
+
+/**
+ * @brief Phases of the simulation timed by the profiler.
+ */
+enum class Phase : unsigned int {
+	Connect, //!< Drawing of the stored connections (Network::connect)
+	Update, //!< Update of the partition of a thread for a whole window (Network::updatePartition)
+	Membrane, //!< Membrane kernel and emptying of the slot read, inside Update
+	External, //!< Poisson draw of the external spikes, inside Update
+	Collect, //!< Compaction of the spike mask into the lists of the spikes, inside Update
+	Gather, //!< Merge of the lists of the spikes of the threads
+	Delivery, //!< Transmission of the spikes of the window to the targets of the partition of a thread
+	Record, //!< Records of the spikes and of the rates, handed over to the recorder thread
+	Checkpoint, //!< Periodic snapshot
+	Output //!< Flush of the recorder and write of the rates at the end of the simulation
+};
+
+const unsigned int NbPhases = 10; //!< Number of phases
+
+/**
+ * @brief Get the name of a phase.
+ */
+std::string getName(Phase phase);
+
+/**
+ * @brief Time interval spent by a thread in a phase.
+ */
+struct PhaseEvent {
+	Phase phase; //!< Phase
+	unsigned int window; //!< Window of the simulation during which the phase ran
+	int64_t start; //!< Start time (ns since the creation of the profiler)
+	int64_t duration; //!< Duration (ns)
+	unsigned long count; //!< Number of scopes merged into the event (1 except for the phases inside Update)
+	uint64_t counters[NbCounters]; //!< Events counted by the thread during the phase (0 without counters)
+};
+
+/*!
+ * @class Profiler
+ *
+ * @brief Time spent in each phase of the simulation, per window and per thread.
+ *
+ * The phases are timed by PhaseTimer scopes, written with the macro PROFILE_PHASE: the timers are only compiled
+ * when NEURON_PROFILE is defined (cmake -DNEURON_PROFILE=ON), otherwise they cost nothing and the profiler stays empty.
+ *
+ * Each thread records its events in its own list, so the timers need no lock.
+ * The phases inside Update (Membrane, External, Collect) run for every chunk of neurons and every step: they are
+ * summed over the window, and recorded one after the other at the start of their Update event.
+ *
+ * With setCounters, the timers also read the performance counters of their thread (cycles, instructions,
+ * cache and branch misses, see PerfCounters), so the events of each phase carry what the processor counted.
+ * Each thread opens its counters itself the first time it records a phase.
+ */
+class Profiler {
+
+public:
+#ifdef NEURON_PROFILE
+	static const bool Enabled = true; //!< Whether the timers are compiled
+#else
+	static const bool Enabled = false; //!< Whether the timers are compiled
+#endif
+
+	typedef std::chrono::steady_clock Clock; //!< Clock of the timers
+
+	/**
+	 * @brief Constructor, for one thread
+	 */
+	Profiler();
+
+	/**
+	 * @brief Set the number of threads recording events (the events of the threads already recorded are kept).
+	 *
+	 * The threads are new ones: their performance counters are opened again.
+	 */
+	void setNbThreads(unsigned int nbThreads);
+
+	/**
+	 * @brief Get the number of threads which may record events.
+	 */
+	unsigned int getNbThreads() const;
+
+	/**
+	 * @brief Start the next window: the events recorded after belong to it.
+	 *
+	 * @note Called between two windows, when no other thread records events.
+	 */
+	void nextWindow();
+
+	/**
+	 * @brief Get the number of windows started.
+	 */
+	unsigned int getNbWindows() const;
+
+	/**
+	 * @brief Read the performance counters in the timers.
+	 *
+	 * The counters are only read if the calling thread can open at least one of them: when the processor or the
+	 * kernel does not allow it (virtual machine, /proc/sys/kernel/perf_event_paranoid), the phases are only timed.
+	 *
+	 * @return whether the counters are read
+	 */
+	bool setCounters(bool enabled);
+
+	/**
+	 * @brief Whether the timers read the performance counters.
+	 */
+	bool hasCounters() const;
+
+	/**
+	 * @brief Whether a counter is read by the timers.
+	 */
+	bool isAvailable(Counter counter) const;
+
+	/**
+	 * @brief Read the performance counters of the calling thread, the thread t of the simulation.
+	 *
+	 * @note Called by PhaseTimer. The counters are opened when another thread had them (new threads of the simulation):
+	 * two values only make a difference when they come from the same opening.
+	 *
+	 * @return the number of the opening of the counters read (1 for the first one), 0 if they could not be read
+	 */
+	unsigned long readCounters(unsigned int thread, uint64_t values[NbCounters]);
+
+	/**
+	 * @brief Record a time interval spent by a thread in a phase.
+	 *
+	 * @param counters are the events counted during the phase (none without counters)
+	 */
+	void record(unsigned int thread, Phase phase, Clock::time_point start, Clock::time_point stop, const uint64_t* counters = nullptr);
+
+	/**
+	 * @brief Get the events recorded by a thread, in order of their end.
+	 */
+	const std::vector<PhaseEvent>& getEvents(unsigned int thread) const;
+
+	/**
+	 * @brief Get the total time spent by all the threads in a phase (s).
+	 */
+	double getTotal(Phase phase) const;
+
+	/**
+	 * @brief Remove all the events.
+	 */
+	void clear();
+
+	/**
+	 * @brief Add the memory of the events ("profiler") to a report.
+	 */
+	void reportMemory(MemoryReport& report) const;
+
+	/**
+	 * @brief Get the memory of a profiler whose threads recorded a number of events each (bytes).
+	 */
+	static size_t getMemory(unsigned int nbThreads, size_t nbEvents);
+
+	/**
+	 * @brief Write the summary table: for each phase, the number of calls, the total time, the time of the slowest
+	 * thread per window (mean and maximum) and the time of each thread.
+	 *
+	 * With the counters, a second table gives for each phase the instructions per cycle, the miss rates of the
+	 * cache and of the branches, and the totals of the counters.
+	 */
+	void writeSummary(std::ostream& out) const;
+
+	/**
+	 * @brief Write the events in the Chrome trace-event format (chrome://tracing, Perfetto).
+	 */
+	void writeTrace(std::ostream& out) const;
+
+	/**
+	 * @brief Write the events in the Chrome trace-event format into a file.
+	 *
+	 * @return whether the file could be written
+	 */
+	bool writeTrace(const std::string& path) const;
+
+private:
+
+	/**
+	 * @brief Write the table of the performance counters of the phases.
+	 */
+	void writeCounters(std::ostream& out) const;
+
+	/**
+	 * @brief Events of one thread
+	 */
+	struct ThreadEvents {
+		ThreadEvents();
+		void clearInner();
+
+		std::vector<PhaseEvent> events; //!< Events recorded
+		int64_t inner[NbPhases]; //!< Time spent in the phases inside Update since the last Update event (ns)
+		unsigned long nbInner[NbPhases]; //!< Number of scopes of the phases inside Update since the last Update event
+		uint64_t innerCounters[NbPhases][NbCounters]; //!< Events counted in the phases inside Update since the last Update event
+		std::unique_ptr<PerfCounters> counters; //!< Performance counters of the thread
+		unsigned long nbOpenings; //!< Number of times the counters were opened
+		char padding[64]; //!< The events of two threads are not on the same cache line
+	};
+
+	Clock::time_point origin_; //!< Time 0 of the events
+
+	std::vector<ThreadEvents> threads_; //!< Events of each thread
+
+	unsigned int window_; //!< Current window
+
+	bool counters_; //!< Whether the timers read the performance counters
+
+	bool available_[NbCounters]; //!< Counters that could be opened
+};
+
+/*!
+ * @class PhaseTimer
+ *
+ * @brief Records the time spent by a thread in a phase from its construction to its destruction.
+ */
+class PhaseTimer {
+
+public:
+	/**
+	 * @brief Constructor: start of the phase
+	 */
+	PhaseTimer(Profiler& profiler, Phase phase, unsigned int thread);
+
+	/**
+	 * @brief Destructor: end of the phase, recorded into the profiler
+	 */
+	~PhaseTimer();
+
+	PhaseTimer(const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+
+	Profiler& profiler_; //!< Profiler recording the phase
+
+	Phase phase_; //!< Phase timed
+
+	unsigned int thread_; //!< Thread running the phase
+
+	Profiler::Clock::time_point start_; //!< Start of the phase
+
+	uint64_t counters_[NbCounters]; //!< Performance counters at the start of the phase
+
+	unsigned long opening_; //!< Opening of the counters read at the start of the phase (0 if not read)
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+/**
+ * @brief Time the rest of the enclosing scope as a phase of a thread (nothing unless NEURON_PROFILE is defined).
+ */
+#ifdef NEURON_PROFILE
+#define PROFILE_PHASE(profiler, phase, thread) PhaseTimer PROFILE_CONCAT(phaseTimer, __LINE__)((profiler), (phase), (thread))
+#else
+#define PROFILE_PHASE(profiler, phase, thread) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef random_H
+#define random_H
+#include <cstdint>
+#include <array>
+
+/*!
+ * @class Philox
+ *
+ * @brief Counter-based random generator Philox4x32-10 (Salmon et al., Random123, 2011).
+ *
+ * The random numbers are a function of a counter and a key: the same (counter, key) always
+ * gives the same four 32 bits numbers. There is no state to share between threads and any
+ * number of the sequence can be generated directly, without generating the previous ones.
+ */
+class Philox {
+
+public:
+	typedef std::array<uint32_t, 4> Counter; //!< Position in the sequence
+	typedef std::array<uint32_t, 2> Key; //!< Identifies the sequence (the seed)
+
+	/**
+	 * @brief Generate the four random numbers of a counter.
+	 *
+	 * @param counter is the position in the sequence
+	 * @param key identifies the sequence
+	 *
+	 * @return four independent uniformly distributed 32 bits numbers
+	 */
+	static Counter generate(Counter counter, Key key)
+	{
+		for (unsigned int round(0); round < 10; ++round) {
+			uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * counter[0];
+			uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * counter[2];
+			counter = {{ static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+			             static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0) }};
+			key[0] += 0x9E3779B9u;
+			key[1] += 0xBB67AE85u;
+		}
+		return counter;
+	}
+
+	/**
+	 * @brief Split a 64 bits seed into a key.
+	 */
+	static Key key(uint64_t seed)
+	{
+		return {{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }};
+	}
+
+	/**
+	 * @brief Convert a random number into a uniformly distributed integer of [0, n).
+	 *
+	 * @note Multiply and shift: the bias is at most n / 2^32.
+	 */
+	static uint32_t toIndex(uint32_t x, uint32_t n)
+	{
+		return static_cast<uint32_t>((static_cast<uint64_t>(x) * n) >> 32);
+	}
+
+	/**
+	 * @brief Convert a random number into a uniformly distributed double of [0, 1).
+	 */
+	static double toUniform(uint32_t x)
+	{
+		return x * (1.0/4294967296.0);
+	}
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "rate_recorder.hpp"
+#include "constants.hpp"
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+static_assert(sizeof(RateFileHeader) == 32, "the header of a rate file is 32 bytes");
+
+//======================================================================
+//constructeurs/destructeurs
+RateRecorder::RateRecorder(double binWidth, double start, double stop, double timeStep)
+: timeStep_(timeStep), binSteps_(max(1L, lround(binWidth/timeStep))), startStep_(max(0L, lround(start/timeStep))),
+  stopStep_(isinf(stop) ? numeric_limits<unsigned long>::max() : max(0L, lround(stop/timeStep)))
+{}
+//======================================================================
+//getter
+double RateRecorder::getBinWidth() const
+{
+	return binSteps_*timeStep_;
+}
+//----------------------------------------------------------------------
+double RateRecorder::getStart() const
+{
+	return startStep_*timeStep_;
+}
+//----------------------------------------------------------------------
+size_t RateRecorder::getNbBins() const
+{
+	return excitatory_.size();
+}
+//----------------------------------------------------------------------
+double RateRecorder::getTime(size_t bin) const
+{
+	return (startStep_ + bin*binSteps_)*timeStep_;
+}
+//----------------------------------------------------------------------
+unsigned int RateRecorder::getNbExcitatorySpikes(size_t bin) const
+{
+	return excitatory_[bin];
+}
+//----------------------------------------------------------------------
+unsigned int RateRecorder::getNbInhibitorySpikes(size_t bin) const
+{
+	return inhibitory_[bin];
+}
+//======================================================================
+void RateRecorder::record(unsigned long step, const vector<unsigned int>& spikes, const NeuronPopulation& population)
+{
+	if (step < startStep_ or step >= stopStep_) {
+		return;
+	}
+	
+	// the bins are created as the simulation goes, even the bins without spikes
+	size_t bin = (step - startStep_)/binSteps_;
+	if (bin >= excitatory_.size()) {
+		excitatory_.resize(bin+1, 0);
+		inhibitory_.resize(bin+1, 0);
+	}
+	
+	for (auto i : spikes) {
+		if (population.isInhibiter(i)) {
+			++inhibitory_[bin];
+		} else {
+			++excitatory_[bin];
+		}
+	}
+}
+//======================================================================
+bool RateRecorder::writeCSV(const string& path) const
+{
+	ofstream file(path);
+	if (file.fail()) {
+		return false;
+	}
+	
+	file << "time,excitatory,inhibitory" << '\n';
+	for (size_t bin(0); bin < getNbBins(); ++bin) {
+		file << getTime(bin) << "," << excitatory_[bin] << "," << inhibitory_[bin] << '\n';
+	}
+	return not file.fail();
+}
+//----------------------------------------------------------------------
+bool RateRecorder::writeBinary(const string& path) const
+{
+	ofstream file(path, ios::binary | ios::trunc);
+	if (file.fail()) {
+		return false;
+	}
+	
+	RateFileHeader header;
+	memcpy(header.magic, "RATE", 4);
+	header.version = 1;
+	header.binWidth = getBinWidth();
+	header.start = getStart();
+	header.nbBins = getNbBins();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	
+	// the counts of a bin are written side by side
+	vector<uint32_t> counts;
+	counts.reserve(2*getNbBins());
+	for (size_t bin(0); bin < getNbBins(); ++bin) {
+		counts.push_back(excitatory_[bin]);
+		counts.push_back(inhibitory_[bin]);
+	}
+	file.write(reinterpret_cast<const char*>(counts.data()), counts.size()*sizeof(uint32_t));
+	return not file.fail();
+}
+//======================================================================
+//Memory
+void RateRecorder::reportMemory(MemoryReport& report) const
+{
+	report.add("rates", excitatory_);
+	report.add("rates", inhibitory_);
+}
+//======================================================================
@@ -0,0 +1,123 @@
+#ifndef rate_recorder_H
+#define rate_recorder_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include "population.hpp"
+#include "memory_report.hpp"
+
+/**
+ * @brief Header of a binary rate file.
+ *
+ * The file is the header followed by nbBins pairs of little-endian 32 bits integers:
+ * the numbers of spikes of the excitatory and of the inhibitory neurons during each bin.
+ */
+struct RateFileHeader {
+	char magic[4]; //!< "RATE"
+	uint32_t version; //!< Version of the format
+	double binWidth; //!< Width of the bins (ms)
+	double start; //!< Start time of the first bin (ms)
+	uint64_t nbBins; //!< Number of bins
+};
+
+/*!
+ * @class RateRecorder
+ *
+ * @brief Counts the spikes of the population in bins of time during the simulation.
+ *
+ * The spikes of the excitatory and of the inhibitory neurons are counted separately, in memory,
+ * for the bins of a time window. The rates are written at the end of the simulation (CSV or binary),
+ * so the histograms of the activity do not need the record of every spike.
+ *
+ * @note The rate of a population in Hz is count / (number of neurons of the population * binWidth) * 1000.
+ */
+class RateRecorder {
+
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param binWidth is the width of the bins (ms, rounded to a number of steps, at least one step)
+	 * @param start is the start time of the window (ms, a negative time starts at 0)
+	 * @param stop is the end time of the window (ms, a negative time records nothing, infinity for no end)
+	 * @param timeStep is the step time of the simulation (ms, Parameters::dt of the simulation)
+	 */
+	RateRecorder(double binWidth, double start, double stop, double timeStep);
+
+	/**
+	 * @brief Get the width of the bins (ms).
+	 */
+	double getBinWidth() const;
+
+	/**
+	 * @brief Get the start time of the window (ms).
+	 */
+	double getStart() const;
+
+	/**
+	 * @brief Get the number of bins recorded.
+	 */
+	size_t getNbBins() const;
+
+	/**
+	 * @brief Get the start time of a bin (ms).
+	 */
+	double getTime(size_t bin) const;
+
+	/**
+	 * @brief Get the number of spikes of the excitatory neurons during a bin.
+	 */
+	unsigned int getNbExcitatorySpikes(size_t bin) const;
+
+	/**
+	 * @brief Get the number of spikes of the inhibitory neurons during a bin.
+	 */
+	unsigned int getNbInhibitorySpikes(size_t bin) const;
+
+	/**
+	 * @brief Count the spikes of a step.
+	 *
+	 * @param step is the step time of the spikes
+	 * @param spikes are the neurons that spiked
+	 * @param population gives the type of the neurons
+	 *
+	 * @note The spikes outside the window are ignored.
+	 */
+	void record(unsigned long step, const std::vector<unsigned int>& spikes, const NeuronPopulation& population);
+
+	/**
+	 * @brief Write the bins in a CSV file: header "time,excitatory,inhibitory", then one line per bin.
+	 *
+	 * @return whether the file could be written
+	 */
+	bool writeCSV(const std::string& path) const;
+
+	/**
+	 * @brief Write the bins in a binary file (see RateFileHeader).
+	 *
+	 * @return whether the file could be written
+	 */
+	bool writeBinary(const std::string& path) const;
+
+	/**
+	 * @brief Add the memory of the bins ("rates") to a report.
+	 */
+	void reportMemory(MemoryReport& report) const;
+
+private:
+
+	double timeStep_; //!< Step time of the simulation (ms)
+
+	unsigned long binSteps_; //!< Width of the bins (in step time)
+
+	unsigned long startStep_; //!< First step of the window
+
+	unsigned long stopStep_; //!< Step following the window
+
+	std::vector<uint32_t> excitatory_; //!< Number of spikes of the excitatory neurons of each bin
+
+	std::vector<uint32_t> inhibitory_; //!< Number of spikes of the inhibitory neurons of each bin
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "scaling.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+//======================================================================
+string getName(Connectivity connectivity)
+{
+	return connectivity == Connectivity::Procedural ? "procedural" : "stored";
+}
+//----------------------------------------------------------------------
+vector<ScalingConfiguration> getScalingConfigurations(const vector<unsigned int>& nbNeurons, const vector<Connectivity>& connectivities,
+                                                      const vector<unsigned int>& nbThreads, bool weak)
+{
+	vector<ScalingConfiguration> configurations;
+
+	for (unsigned int n : nbNeurons) {
+		for (Connectivity connectivity : connectivities) {
+			for (unsigned int threads : nbThreads) {
+				configurations.push_back({ weak ? n*threads : n, connectivity, threads });
+			}
+		}
+	}
+	return configurations;
+}
+//======================================================================
+//Simulation of one configuration, in the forked process
+static ScalingResult measure(const ScalingConfiguration& configuration, double stopTime, const Parameters& parameters)
+{
+	ScalingResult result;
+	result.configuration = configuration;
+	result.simulatedTime = stopTime;
+
+	auto start = chrono::steady_clock::now();
+	Network network(stopTime, configuration.nbNeurons, configuration.connectivity, parameters, Network::DefaultSeed, "");
+	network.setNbThreads(configuration.nbThreads);
+	auto setup = chrono::steady_clock::now();
+
+	network.update();
+	auto stop = chrono::steady_clock::now();
+
+	result.setupSeconds = chrono::duration<double>(setup - start).count();
+	result.wallSeconds = chrono::duration<double>(stop - setup).count();
+	result.realTimeFactor = stopTime/1000.0/result.wallSeconds;
+
+	result.nbSpikes = 0;
+	for (unsigned int i(0); i < configuration.nbNeurons; ++i) {
+		result.nbSpikes += network.getPopulation().getNbSpikes(i);
+	}
+	result.spikesPerSecond = result.nbSpikes/result.wallSeconds;
+
+	// ru_maxrss is in kB on Linux
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	result.peakMemory = usage.ru_maxrss/1024.0;
+	return result;
+}
+//----------------------------------------------------------------------
+bool runScaling(const ScalingConfiguration& configuration, double stopTime, const Parameters& parameters, ScalingResult& result)
+{
+	int channel[2];
+	if (pipe(channel) != 0) {
+		cerr << "Error creating pipe" << endl;
+		return false;
+	}
+	cout.flush();
+	cerr.flush();
+
+	pid_t pid = fork();
+	if (pid == 0) {
+		// the result goes back to the calling process through the pipe
+		close(channel[0]);
+		ScalingResult measured = measure(configuration, stopTime, parameters);
+		bool written = write(channel[1], &measured, sizeof(measured)) == static_cast<ssize_t>(sizeof(measured));
+		_exit(written ? 0 : 1);
+	}
+	close(channel[1]);
+
+	if (pid < 0) {
+		cerr << "Error forking configuration" << endl;
+		close(channel[0]);
+		return false;
+	}
+
+	// the child writes the result at once at the end: a short read means it failed
+	size_t size(0);
+	char* data = reinterpret_cast<char*>(&result);
+	ssize_t count;
+	while (size < sizeof(result) and (count = read(channel[0], data + size, sizeof(result) - size)) > 0) {
+		size += count;
+	}
+	close(channel[0]);
+
+	int status;
+	if (waitpid(pid, &status, 0) < 0 or not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+		return false;
+	}
+	return size == sizeof(result);
+}
+//======================================================================
+//JSON files of the results
+void writeScalingResults(ostream& out, const vector<ScalingResult>& results)
+{
+	streamsize precision = out.precision(6);
+
+	out << "{\n  \"cores\": " << thread::hardware_concurrency() << ",\n  \"results\": [\n";
+	for (size_t k(0); k < results.size(); ++k) {
+		const ScalingResult& result = results[k];
+		out << "    { \"neurons\": " << result.configuration.nbNeurons
+		    << ", \"connectivity\": \"" << getName(result.configuration.connectivity) << '"'
+		    << ", \"threads\": " << result.configuration.nbThreads
+		    << ", \"time_ms\": " << result.simulatedTime
+		    << ", \"setup_seconds\": " << result.setupSeconds
+		    << ", \"wall_seconds\": " << result.wallSeconds
+		    << ", \"realtime_factor\": " << result.realTimeFactor
+		    << ", \"peak_rss_mb\": " << result.peakMemory
+		    << ", \"spikes\": " << result.nbSpikes
+		    << ", \"spikes_per_second\": " << result.spikesPerSecond
+		    << " }" << (k + 1 < results.size() ? "," : "") << '\n';
+	}
+	out << "  ]\n}\n";
+
+	out.precision(precision);
+}
+//----------------------------------------------------------------------
+//Value of a field of a line written by writeScalingResults (empty if the line does not have it)
+static string getField(const string& line, const string& name)
+{
+	string key = '"' + name + "\": ";
+	size_t begin = line.find(key);
+	if (begin == string::npos) {
+		return "";
+	}
+	begin += key.size();
+	size_t end = line.find_first_of(",}", begin);
+	string value = line.substr(begin, end == string::npos ? string::npos : end - begin);
+
+	// quotes of a string, spaces before the separator
+	value.erase(value.find_last_not_of(' ') + 1);
+	if (value.size() >= 2 and value.front() == '"' and value.back() == '"') {
+		value = value.substr(1, value.size() - 2);
+	}
+	return value;
+}
+//----------------------------------------------------------------------
+vector<ScalingResult> readScalingResults(const string& path)
+{
+	vector<ScalingResult> results;
+	ifstream file(path);
+	string line;
+
+	// one result per line
+	while (getline(file, line)) {
+		if (getField(line, "neurons").empty()) {
+			continue;
+		}
+		ScalingResult result;
+		result.configuration.nbNeurons = strtoul(getField(line, "neurons").c_str(), nullptr, 10);
+		result.configuration.connectivity = getField(line, "connectivity") == "procedural" ? Connectivity::Procedural : Connectivity::Stored;
+		result.configuration.nbThreads = strtoul(getField(line, "threads").c_str(), nullptr, 10);
+		result.simulatedTime = atof(getField(line, "time_ms").c_str());
+		result.setupSeconds = atof(getField(line, "setup_seconds").c_str());
+		result.wallSeconds = atof(getField(line, "wall_seconds").c_str());
+		result.realTimeFactor = atof(getField(line, "realtime_factor").c_str());
+		result.peakMemory = atof(getField(line, "peak_rss_mb").c_str());
+		result.nbSpikes = strtoul(getField(line, "spikes").c_str(), nullptr, 10);
+		result.spikesPerSecond = atof(getField(line, "spikes_per_second").c_str());
+		results.push_back(result);
+	}
+	return results;
+}
+//======================================================================
+//Comparison with a baseline
+unsigned int compareScaling(const vector<ScalingResult>& results, const vector<ScalingResult>& baseline,
+                            double threshold, ostream& report, double minSeconds)
+{
+	unsigned int nbRegressions(0);
+	streamsize precision = report.precision();
+
+	for (const ScalingResult& result : results) {
+		const ScalingConfiguration& configuration = result.configuration;
+		for (const ScalingResult& reference : baseline) {
+			if (reference.configuration.nbNeurons != configuration.nbNeurons
+			    or reference.configuration.connectivity != configuration.connectivity
+			    or reference.configuration.nbThreads != configuration.nbThreads
+			    or reference.simulatedTime != result.simulatedTime or reference.wallSeconds < minSeconds) {
+				continue;
+			}
+
+			double ratio = result.wallSeconds/reference.wallSeconds;
+			bool regression = ratio > 1.0 + threshold;
+			nbRegressions += regression;
+
+			report << configuration.nbNeurons << " neurons, " << getName(configuration.connectivity) << ", "
+			       << configuration.nbThreads << " threads: " << fixed << setprecision(3) << result.wallSeconds
+			       << " s against " << reference.wallSeconds << " s (x" << setprecision(2) << ratio << ")"
+			       << (regression ? " REGRESSION" : "") << defaultfloat << endl;
+			break;
+		}
+	}
+	report.precision(precision);
+	return nbRegressions;
+}
+//======================================================================
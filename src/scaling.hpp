@@ -0,0 +1,87 @@
+#ifndef scaling_H
+#define scaling_H
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include "network.hpp"
+#include "parameters.hpp"
+
+/**
+ * @brief One simulation of a scaling run: a number of neurons, a storage of the connections and a number of threads.
+ */
+struct ScalingConfiguration {
+	unsigned int nbNeurons; //!< Number of neurons of the network
+	Connectivity connectivity; //!< Storage of the connections
+	unsigned int nbThreads; //!< Number of threads of the simulation
+};
+
+/**
+ * @brief Measures of the simulation of a configuration.
+ */
+struct ScalingResult {
+	ScalingConfiguration configuration; //!< Configuration simulated
+	double simulatedTime; //!< Duration of the simulation (ms)
+	double setupSeconds; //!< Wall-clock time of the construction of the network, connections included (s)
+	double wallSeconds; //!< Wall-clock time of the simulation (s)
+	double realTimeFactor; //!< Simulated time per wall-clock time (above 1: faster than real time)
+	double peakMemory; //!< Peak resident memory of the process simulating the configuration (MB)
+	unsigned long nbSpikes; //!< Number of spikes of the simulation
+	double spikesPerSecond; //!< Number of spikes per wall-clock second
+};
+
+/**
+ * @brief Get the name of a storage of the connections: "stored" or "procedural".
+ */
+std::string getName(Connectivity connectivity);
+
+/**
+ * @brief Get the configurations of a scaling run: every combination of the numbers of neurons, of the storages
+ * and of the numbers of threads.
+ *
+ * @param weak whether the numbers of neurons are per thread (weak scaling: the network grows with the threads)
+ * instead of for the whole network (strong scaling)
+ */
+std::vector<ScalingConfiguration> getScalingConfigurations(const std::vector<unsigned int>& nbNeurons,
+                                                           const std::vector<Connectivity>& connectivities,
+                                                           const std::vector<unsigned int>& nbThreads, bool weak = false);
+
+/**
+ * @brief Simulate a configuration in a forked process and measure it.
+ *
+ * Each configuration runs in its own process, so that its peak resident memory is not the one of the
+ * configurations simulated before. The network is built with the given parameters and the default seed,
+ * without file.
+ *
+ * @param stopTime is the duration of the simulation (ms)
+ * @param result receives the measures
+ *
+ * @return whether the simulation succeeded
+ */
+bool runScaling(const ScalingConfiguration& configuration, double stopTime, const Parameters& parameters, ScalingResult& result);
+
+/**
+ * @brief Write the results of a scaling run as JSON, one result per line.
+ */
+void writeScalingResults(std::ostream& out, const std::vector<ScalingResult>& results);
+
+/**
+ * @brief Read results written by writeScalingResults.
+ *
+ * @return the results of the file (none if the file does not exist)
+ */
+std::vector<ScalingResult> readScalingResults(const std::string& path);
+
+/**
+ * @brief Compare the wall-clock times of results with those of a baseline.
+ *
+ * A result is a regression when its simulation is more than 1 + threshold times slower than the result
+ * of the same configuration in the baseline (same number of neurons, storage, threads and duration).
+ * The runs shorter than minSeconds in the baseline are not compared: their times are mostly noise.
+ * A line is written to report for each result compared.
+ *
+ * @return the number of regressions
+ */
+unsigned int compareScaling(const std::vector<ScalingResult>& results, const std::vector<ScalingResult>& baseline,
+                            double threshold, std::ostream& report, double minSeconds = 0.05);
+
+#endif
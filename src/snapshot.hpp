@@ -0,0 +1,80 @@
+#ifndef snapshot_H
+#define snapshot_H
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Header of a snapshot of the network (see Network::save).
+ *
+ * The header is followed by the parameters of the model (see Parameters), the population (see NeuronPopulation::save),
+ * then the connections (offsets and targets).
+ * Each array is stored as its number of elements (64 bits) followed by its elements.
+ * All the integers are stored in little-endian order.
+ */
+struct SnapshotHeader {
+	char magic[4]; //!< "BRCK"
+	uint32_t version; //!< Version of the format
+	uint32_t nbNeurons; //!< Number of neurons of the network
+	uint32_t nbSlots; //!< Number of slots of the delay ring
+	uint64_t clock; //!< Step time of the network
+	uint64_t seed; //!< Seed of the connections
+	uint64_t externalSeed; //!< Seed of the external spikes (they only depend on the seed and the step time)
+	uint32_t readBox; //!< Slot of the delay ring read at the next step
+	uint32_t writeBox; //!< Slot of the delay ring written at the next step
+	uint32_t connectivity; //!< Storage of the connections: 0 stored, 1 procedural
+	uint32_t reserved; //!< Zero
+};
+
+/**
+ * @brief Write an array into a snapshot: number of elements, then the elements.
+ */
+template <typename T>
+void writeArray(std::ostream& out, const std::vector<T>& array)
+{
+	uint64_t size = array.size();
+	out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	out.write(reinterpret_cast<const char*>(array.data()), array.size()*sizeof(T));
+}
+
+/**
+ * @brief Get the number of bytes left in a stream (the maximum if the stream cannot seek).
+ */
+inline uint64_t getRemaining(std::istream& in)
+{
+	std::istream::pos_type position = in.tellg();
+	if (position == std::istream::pos_type(-1) or not in.seekg(0, std::ios::end)) {
+		in.clear();
+		return UINT64_MAX;
+	}
+	std::istream::pos_type end = in.tellg();
+	in.seekg(position);
+	return static_cast<uint64_t>(end - position);
+}
+
+/**
+ * @brief Read an array from a snapshot.
+ *
+ * The number of elements comes from the file: it is checked before the array is allocated, so a truncated or
+ * corrupt snapshot is rejected instead of allocating an arbitrary size.
+ *
+ * @param array receives the elements, its size is changed if needed
+ * @param maxSize is the largest number of elements accepted
+ *
+ * @return whether the array could be read (at most maxSize elements, all of them in the stream)
+ */
+template <typename T>
+bool readArray(std::istream& in, std::vector<T>& array, uint64_t maxSize = UINT64_MAX)
+{
+	uint64_t size;
+	if (not in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+		return false;
+	}
+	if (size > maxSize or size > getRemaining(in)/sizeof(T)) {
+		return false;
+	}
+	array.resize(size);
+	return static_cast<bool>(in.read(reinterpret_cast<char*>(array.data()), size*sizeof(T)));
+}
+
+#endif
@@ -0,0 +1,384 @@
+#include "spike_codec.hpp"
+#include <cstring>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+
+static_assert(sizeof(SpikeArchiveHeader) == 48, "the header of a spike archive is 48 bytes");
+static_assert(sizeof(SpikeBlock) == 24, "an entry of the index of a spike archive is 24 bytes");
+
+static const char Magic[4] = { 'S', 'P', 'K', 'Z' };
+
+//======================================================================
+//Varints: 7 bits per byte, the high bit is set if another byte follows
+static inline void putVarint(uint64_t x, vector<uint8_t>& out)
+{
+	while (x >= 0x80) {
+		out.push_back(static_cast<uint8_t>(x) | 0x80);
+		x >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(x));
+}
+//----------------------------------------------------------------------
+static inline uint64_t getVarint(const uint8_t*& p, const uint8_t* end)
+{
+	// a corrupt varint stops at the end of the block or after 64 bits
+	uint64_t x(0);
+	for (unsigned int shift(0); shift < 64 and p != end; shift += 7) {
+		uint8_t byte = *p++;
+		x |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (byte < 0x80) {
+			break;
+		}
+	}
+	return x;
+}
+//----------------------------------------------------------------------
+//Bits: written from the lowest bit of each byte
+static inline void putBits(uint64_t value, unsigned int width, uint64_t& buffer, unsigned int& nbBits, vector<uint8_t>& out)
+{
+	assert(width <= 56);
+	buffer |= (value & ((uint64_t(1) << width) - 1)) << nbBits;
+	nbBits += width;
+	while (nbBits >= 8) {
+		out.push_back(static_cast<uint8_t>(buffer));
+		buffer >>= 8;
+		nbBits -= 8;
+	}
+}
+//----------------------------------------------------------------------
+static inline void flushBits(uint64_t& buffer, unsigned int& nbBits, vector<uint8_t>& out)
+{
+	if (nbBits > 0) {
+		out.push_back(static_cast<uint8_t>(buffer));
+	}
+	buffer = 0;
+	nbBits = 0;
+}
+//----------------------------------------------------------------------
+//8 bytes from a position of a block (the padding of the block keeps the load inside the block)
+static inline uint64_t getWord(const uint8_t* p)
+{
+	uint64_t word;
+	memcpy(&word, p, sizeof(word));
+	return word;
+}
+//======================================================================
+//Codec
+void SpikeCodec::encode(const SpikeRecord* records, size_t nbRecords, uint64_t firstStep, uint32_t nbNeurons, vector<uint8_t>& out)
+{
+	assert(nbNeurons > 0);
+	
+	// the width of the rests which gives the smallest block: the quotient in unary and the rest, or the escape
+	uint64_t sizes[MaxWidth + 1] = {};
+	uint64_t previous(0);
+	for (size_t i(0); i < nbRecords; ++i) {
+		assert(records[i].step >= firstStep and records[i].neuron < nbNeurons);
+		uint64_t position = (records[i].step - firstStep)*uint64_t(nbNeurons) + records[i].neuron;
+		assert(position >= previous);
+		for (unsigned int width(0); width <= MaxWidth; ++width) {
+			uint64_t quotient = (position - previous) >> width;
+			sizes[width] += (quotient < Escape ? quotient : Escape + 64) + 1 + width;
+		}
+		previous = position;
+	}
+	unsigned int width = min_element(sizes, sizes + MaxWidth + 1) - sizes;
+	
+	// the three parts of the block
+	vector<uint64_t> escapes;
+	vector<uint8_t> rests, quotients;
+	uint64_t restBuffer(0), quotientBuffer(0);
+	unsigned int nbRestBits(0), nbQuotientBits(0);
+	previous = 0;
+	for (size_t i(0); i < nbRecords; ++i) {
+		uint64_t position = (records[i].step - firstStep)*uint64_t(nbNeurons) + records[i].neuron;
+		uint64_t gap = position - previous;
+		uint64_t quotient = min<uint64_t>(gap >> width, Escape);
+		if (quotient == Escape) {
+			escapes.push_back(gap);
+		}
+		putBits(gap, width, restBuffer, nbRestBits, rests);
+		putBits((uint64_t(1) << quotient) - 1, quotient + 1, quotientBuffer, nbQuotientBits, quotients);
+		previous = position;
+	}
+	flushBits(restBuffer, nbRestBits, rests);
+	flushBits(quotientBuffer, nbQuotientBits, quotients);
+	
+	out.push_back(width);
+	putVarint(escapes.size(), out);
+	for (uint64_t escape : escapes) {
+		for (unsigned int byte(0); byte < 8; ++byte) {
+			out.push_back(static_cast<uint8_t>(escape >> 8*byte));
+		}
+	}
+	out.insert(out.end(), rests.begin(), rests.end());
+	out.insert(out.end(), quotients.begin(), quotients.end());
+	out.insert(out.end(), Padding, 0);
+}
+//----------------------------------------------------------------------
+bool SpikeCodec::decode(const uint8_t* data, size_t nbBytes, uint64_t firstStep, uint32_t nbNeurons, size_t nbRecords,
+                        SpikeRecord* records)
+{
+	// a corrupt block never reads past its bytes: every load starts Padding bytes before its end
+	if (nbNeurons == 0 or nbBytes < 1 + Padding or data[0] > MaxWidth) {
+		return false;
+	}
+	const uint8_t* last = data + nbBytes - Padding;
+	const uint8_t* p = data + 1;
+	unsigned int width = data[0];
+	uint64_t mask = (uint64_t(1) << width) - 1;
+	
+	uint64_t nbEscapes = getVarint(p, last);
+	if (nbEscapes > static_cast<size_t>(last - p)/8) {
+		return false;
+	}
+	const uint8_t* escapes = p;
+	const uint8_t* rests = escapes + 8*nbEscapes;
+	if (nbRecords > static_cast<size_t>(last - rests)*8/max(1u, width)) {
+		return false;
+	}
+	const uint8_t* quotients = rests + (nbRecords*width + 7)/8;
+	
+	// the quotients end at the zeros of the words of their part: one load per 64 bits
+	uint64_t step(firstStep), neuron(0), quotient(0), escape(0);
+	size_t i(0);
+	for (const uint8_t* word = quotients; i < nbRecords; word += 8) {
+		if (word > last) {
+			return false;
+		}
+		uint64_t zeros = ~getWord(word);
+		unsigned int start(0);
+		
+		while (zeros != 0 and i < nbRecords) {
+			unsigned int end = __builtin_ctzll(zeros);
+			quotient += end - start;
+			start = end + 1;
+			zeros &= zeros - 1;
+			
+			uint64_t gap;
+			if (quotient < Escape) {
+				uint64_t bit = i*width;
+				gap = (quotient << width) | ((getWord(rests + bit/8) >> (bit % 8)) & mask);
+			} else if (quotient == Escape and escape < nbEscapes) {
+				gap = getWord(escapes + 8*escape++);
+			} else {
+				return false;
+			}
+			quotient = 0;
+			
+			// the gap goes on with the following steps: a division only when the step changes
+			neuron += gap;
+			if (neuron >= nbNeurons) {
+				step += neuron/nbNeurons;
+				neuron %= nbNeurons;
+			}
+			records[i++] = { static_cast<uint32_t>(step), static_cast<uint32_t>(neuron) };
+		}
+		quotient += 64 - start;
+	}
+	return true;
+}
+//======================================================================
+//Writer
+SpikeArchiveWriter::SpikeArchiveWriter()
+{
+	memset(&header_, 0, sizeof(header_));
+}
+//----------------------------------------------------------------------
+SpikeArchiveWriter::~SpikeArchiveWriter()
+{
+	close();
+}
+//----------------------------------------------------------------------
+bool SpikeArchiveWriter::open(const string& path, unsigned int nbNeurons, double dt)
+{
+	close();
+	
+	file_.open(path, ios::binary | ios::trunc);
+	if (file_.fail()) {
+		return false;
+	}
+	
+	memset(&header_, 0, sizeof(header_));
+	memcpy(header_.magic, Magic, sizeof(Magic));
+	header_.version = 2;
+	header_.nbNeurons = nbNeurons;
+	header_.blockRecords = BlockRecords;
+	header_.dt = dt;
+	
+	// the header is complete once the archive is closed: an archive not closed has no index
+	file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+	
+	blocks_.clear();
+	block_.clear();
+	block_.reserve(BlockRecords);
+	return true;
+}
+//----------------------------------------------------------------------
+bool SpikeArchiveWriter::isOpen() const
+{
+	return file_.is_open();
+}
+//----------------------------------------------------------------------
+void SpikeArchiveWriter::record(const vector<SpikeRecord>& records)
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	for (const auto& record : records) {
+		block_.push_back(record);
+		if (block_.size() == BlockRecords) {
+			writeBlock();
+		}
+	}
+}
+//----------------------------------------------------------------------
+void SpikeArchiveWriter::writeBlock()
+{
+	if (block_.empty()) {
+		return;
+	}
+	
+	encoded_.clear();
+	SpikeCodec::encode(block_.data(), block_.size(), block_.front().step, header_.nbNeurons, encoded_);
+	
+	SpikeBlock block;
+	block.firstStep = block_.front().step;
+	block.offset = file_.tellp();
+	block.nbRecords = block_.size();
+	block.nbBytes = encoded_.size();
+	blocks_.push_back(block);
+	
+	file_.write(reinterpret_cast<const char*>(encoded_.data()), encoded_.size());
+	header_.nbRecords += block_.size();
+	block_.clear();
+}
+//----------------------------------------------------------------------
+void SpikeArchiveWriter::close()
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	writeBlock();
+	
+	// the index is aligned on 8 bytes
+	static const char zeros[8] = {};
+	file_.write(zeros, (8 - file_.tellp() % 8) % 8);
+	
+	header_.nbBlocks = blocks_.size();
+	header_.indexOffset = file_.tellp();
+	file_.write(reinterpret_cast<const char*>(blocks_.data()), blocks_.size()*sizeof(SpikeBlock));
+	
+	file_.seekp(0);
+	file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+	file_.close();
+}
+//======================================================================
+//Reader
+SpikeArchive::SpikeArchive(const string& path)
+: file_(path), header_(nullptr), blocks_(nullptr)
+{
+	if (file_.size() < sizeof(SpikeArchiveHeader)) {
+		return;
+	}
+	
+	const SpikeArchiveHeader* header = reinterpret_cast<const SpikeArchiveHeader*>(file_.data());
+	if (memcmp(header->magic, Magic, sizeof(Magic)) != 0 or header->version != 2
+	    or header->indexOffset < sizeof(SpikeArchiveHeader) or header->indexOffset > file_.size()
+	    or header->nbBlocks > (file_.size() - header->indexOffset)/sizeof(SpikeBlock)) {
+		return;
+	}
+	
+	// every block lies between the header and the index, and the blocks hold the spikes of the header
+	const SpikeBlock* blocks = reinterpret_cast<const SpikeBlock*>(file_.data() + header->indexOffset);
+	uint64_t nbRecords(0);
+	for (uint64_t b(0); b < header->nbBlocks; ++b) {
+		if (blocks[b].offset < sizeof(SpikeArchiveHeader) or blocks[b].offset > header->indexOffset
+		    or blocks[b].nbBytes > header->indexOffset - blocks[b].offset) {
+			return;
+		}
+		nbRecords += blocks[b].nbRecords;
+	}
+	if (nbRecords != header->nbRecords) {
+		return;
+	}
+	header_ = header;
+	blocks_ = blocks;
+}
+//----------------------------------------------------------------------
+bool SpikeArchive::isValid() const
+{
+	return header_ != nullptr;
+}
+//----------------------------------------------------------------------
+const SpikeArchiveHeader& SpikeArchive::getHeader() const
+{
+	return *header_;
+}
+//----------------------------------------------------------------------
+const SpikeBlock& SpikeArchive::getBlock(size_t block) const
+{
+	return blocks_[block];
+}
+//----------------------------------------------------------------------
+bool SpikeArchive::decode(size_t block, vector<SpikeRecord>& records) const
+{
+	records.resize(blocks_[block].nbRecords);
+	if (not SpikeCodec::decode(reinterpret_cast<const uint8_t*>(file_.data() + blocks_[block].offset), blocks_[block].nbBytes,
+	                           blocks_[block].firstStep, header_->nbNeurons, records.size(), records.data())) {
+		records.clear();
+		return false;
+	}
+	return true;
+}
+//----------------------------------------------------------------------
+vector<SpikeRecord> SpikeArchive::decode(double start, double stop) const
+{
+	vector<SpikeRecord> spikes;
+	if (not isValid() or not (start < stop)) {
+		return spikes;
+	}
+	
+	uint64_t startStep = static_cast<uint64_t>(max(0L, lround(start/header_->dt)));
+	uint64_t stopStep = isinf(stop) ? UINT64_MAX : static_cast<uint64_t>(max(0L, lround(stop/header_->dt)));
+	
+	// the block before the first block starting at startStep or after may contain spikes of the window
+	const SpikeBlock* first = lower_bound(blocks_, blocks_ + header_->nbBlocks, startStep,
+	                                      [](const SpikeBlock& b, uint64_t step) { return b.firstStep < step; });
+	if (first != blocks_) {
+		--first;
+	}
+	
+	vector<SpikeRecord> records;
+	for (const SpikeBlock* block = first; block != blocks_ + header_->nbBlocks and block->firstStep < stopStep; ++block) {
+		if (not decode(block - blocks_, records)) {
+			return vector<SpikeRecord>();
+		}
+		for (const auto& record : records) {
+			if (record.step >= startStep and record.step < stopStep) {
+				spikes.push_back(record);
+			}
+		}
+	}
+	return spikes;
+}
+//----------------------------------------------------------------------
+vector<SpikeRecord> SpikeArchive::decodeAll() const
+{
+	vector<SpikeRecord> spikes(isValid() ? header_->nbRecords : 0);
+	
+	size_t position(0);
+	for (size_t block(0); isValid() and block < header_->nbBlocks; ++block) {
+		if (not SpikeCodec::decode(reinterpret_cast<const uint8_t*>(file_.data() + blocks_[block].offset), blocks_[block].nbBytes,
+		                           blocks_[block].firstStep, header_->nbNeurons, blocks_[block].nbRecords, spikes.data() + position)) {
+			return vector<SpikeRecord>();
+		}
+		position += blocks_[block].nbRecords;
+	}
+	return spikes;
+}
+//======================================================================
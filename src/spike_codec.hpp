@@ -0,0 +1,218 @@
+#ifndef spike_codec_H
+#define spike_codec_H
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "spike_recorder.hpp"
+#include "mapped_file.hpp"
+
+/*!
+ * @class SpikeCodec
+ *
+ * @brief Compression of the spikes of a block, in order of time then of neuron.
+ *
+ * A spike is the position step*nbNeurons + neuron from the first step of the block, and the gaps between successive
+ * positions are coded across the steps (Golomb-Rice): the quotient of the gap by 2^width in unary, then its width
+ * lowest bits. The width, chosen for the smallest block, is its first byte; a gap whose quotient reaches Escape is
+ * written as Escape ones then its 64 bits.
+ * A block only depends on its first step: it is decoded alone.
+ *
+ * A gap costs about log2(nbNeurons/spikes per step) + 1.5 bits: about 6 times smaller than the records for the regimes
+ * of 12500 neurons with tens of spikes per step, but with a few spikes per step the neurons themselves are random
+ * and no code gets them under 13 bits (about 4.5 times smaller).
+ */
+class SpikeCodec {
+
+public:
+	/**
+	 * @brief Encode a block of spikes.
+	 *
+	 * @param records are the spikes, in order of time then of neuron
+	 * @param nbRecords is the number of spikes
+	 * @param firstStep is the step of the first spike
+	 * @param nbNeurons is the number of neurons of the network (all the neurons are below)
+	 * @param out receives the encoded block (appended), followed by Padding zero bytes
+	 */
+	static void encode(const SpikeRecord* records, size_t nbRecords, uint64_t firstStep, uint32_t nbNeurons,
+	                   std::vector<uint8_t>& out);
+
+	/**
+	 * @brief Decode a block of spikes.
+	 *
+	 * @param data is the encoded block, followed by Padding bytes
+	 * @param nbBytes is the size of the block, padding included
+	 * @param firstStep is the step of the first spike
+	 * @param nbNeurons is the number of neurons of the network
+	 * @param nbRecords is the number of spikes of the block
+	 * @param records receives the nbRecords spikes
+	 *
+	 * @return whether the block is valid (a corrupt block is never read past nbBytes nor decoded past nbRecords)
+	 */
+	static bool decode(const uint8_t* data, size_t nbBytes, uint64_t firstStep, uint32_t nbNeurons, size_t nbRecords,
+	                   SpikeRecord* records);
+
+	static const size_t Padding = 8; //!< Bytes read after the end of a block by the decoder (8 bytes loads)
+
+	static const unsigned int Escape = 32; //!< Quotient of the gaps written with their 64 bits
+
+	static const unsigned int MaxWidth = 31; //!< Largest number of lowest bits of the gaps
+};
+
+/**
+ * @brief Header of a compressed spike archive.
+ *
+ * The file is the header, then the blocks (see SpikeCodec), then the index of the blocks (nbBlocks SpikeBlock).
+ * All the integers are stored in little-endian order.
+ */
+struct SpikeArchiveHeader {
+	char magic[4]; //!< "SPKZ"
+	uint32_t version; //!< Version of the format (2: gaps across the steps)
+	uint32_t nbNeurons; //!< Number of neurons of the network
+	uint32_t blockRecords; //!< Number of spikes of a block (except the last one)
+	double dt; //!< Step time (ms)
+	uint64_t nbBlocks; //!< Number of blocks
+	uint64_t indexOffset; //!< Position of the index of the blocks in the file (bytes)
+	uint64_t nbRecords; //!< Number of spikes of the archive
+};
+
+/**
+ * @brief Entry of the index of a spike archive: position and content of a block.
+ */
+struct SpikeBlock {
+	uint64_t firstStep; //!< Step of the first spike of the block
+	uint64_t offset; //!< Position of the block in the file (bytes)
+	uint32_t nbRecords; //!< Number of spikes of the block
+	uint32_t nbBytes; //!< Size of the block in the file, padding included (bytes)
+};
+
+/*!
+ * @class SpikeArchiveWriter
+ *
+ * @brief Writes the spikes of a simulation into a compressed spike archive, block after block.
+ */
+class SpikeArchiveWriter {
+
+public:
+	static const uint32_t BlockRecords = 16384; //!< Number of spikes of a block
+
+	/**
+	 * @brief Constructor: the writer ignores the spikes until a file is opened.
+	 */
+	SpikeArchiveWriter();
+
+	/**
+	 * @brief Destructor
+	 *
+	 * @note The archive is closed (see close).
+	 */
+	~SpikeArchiveWriter();
+
+	SpikeArchiveWriter(const SpikeArchiveWriter&) = delete;
+	SpikeArchiveWriter& operator=(const SpikeArchiveWriter&) = delete;
+
+	/**
+	 * @brief Open a file.
+	 *
+	 * @param path is the path of the file
+	 * @param nbNeurons is the number of neurons of the network
+	 * @param dt is the step time (ms)
+	 *
+	 * @return whether the file could be opened
+	 */
+	bool open(const std::string& path, unsigned int nbNeurons, double dt);
+
+	/**
+	 * @brief Whether a file is open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Record spikes, in order of time then of neuron.
+	 */
+	void record(const std::vector<SpikeRecord>& records);
+
+	/**
+	 * @brief Write the last block and the index, then close the file.
+	 */
+	void close();
+
+private:
+
+	/**
+	 * @brief Encode and write the spikes of the current block.
+	 */
+	void writeBlock();
+
+	std::ofstream file_; //!< Archive file
+
+	SpikeArchiveHeader header_; //!< Header, written again when the archive is closed
+
+	std::vector<SpikeBlock> blocks_; //!< Index of the blocks written
+
+	std::vector<SpikeRecord> block_; //!< Spikes of the current block
+
+	std::vector<uint8_t> encoded_; //!< Current block once encoded
+};
+
+/*!
+ * @class SpikeArchive
+ *
+ * @brief Reads a compressed spike archive, mapped in memory.
+ *
+ * The blocks are decoded independently: the spikes of a time window are read by decoding only its blocks.
+ */
+class SpikeArchive {
+
+public:
+	/**
+	 * @brief Constructor: maps the file in memory.
+	 */
+	SpikeArchive(const std::string& path);
+
+	/**
+	 * @brief Whether the file is mapped and is a complete spike archive, whose blocks all lie inside the file.
+	 */
+	bool isValid() const;
+
+	/**
+	 * @brief Get the header of the archive.
+	 */
+	const SpikeArchiveHeader& getHeader() const;
+
+	/**
+	 * @brief Get the entry of the index of a block.
+	 */
+	const SpikeBlock& getBlock(size_t block) const;
+
+	/**
+	 * @brief Decode a block.
+	 *
+	 * @param records receives the spikes of the block (its content is replaced, empty if the block is corrupt)
+	 *
+	 * @return whether the block could be decoded
+	 */
+	bool decode(size_t block, std::vector<SpikeRecord>& records) const;
+
+	/**
+	 * @brief Decode the spikes of the time window [start, stop) (ms).
+	 *
+	 * @note Only the blocks of the window are decoded. The spikes are empty if one of them is corrupt.
+	 */
+	std::vector<SpikeRecord> decode(double start, double stop) const;
+
+	/**
+	 * @brief Decode all the spikes (none if a block is corrupt).
+	 */
+	std::vector<SpikeRecord> decodeAll() const;
+
+private:
+
+	MappedFile file_; //!< Archive file
+
+	const SpikeArchiveHeader* header_; //!< Header of the archive, inside the file
+
+	const SpikeBlock* blocks_; //!< Index of the blocks, inside the file
+};
+
+#endif
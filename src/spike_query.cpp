@@ -0,0 +1,33 @@
+#include "spike_store.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <limits>
+
+using namespace std;
+
+// Spikes of a range of neurons during a time window, read from a spike store
+// Usage: ./spike_query store firstNeuron lastNeuron [start [stop]]
+// Output: one line "step neuron" per spike, neurons of [firstNeuron, lastNeuron) during [start, stop) ms
+int main(int argc, char** argv)
+{
+	if (argc < 4) {
+		cerr << "Usage: " << argv[0] << " store firstNeuron lastNeuron [start [stop]]" << endl;
+		return 1;
+	}
+	
+	SpikeStore store(argv[1]);
+	if (not store.isValid()) {
+		cerr << "Error opening file " << argv[1] << endl;
+		return 1;
+	}
+	
+	unsigned int firstNeuron = strtoul(argv[2], nullptr, 10);
+	unsigned int lastNeuron = strtoul(argv[3], nullptr, 10);
+	double start = argc > 4 ? atof(argv[4]) : 0.0;
+	double stop = argc > 5 ? atof(argv[5]) : numeric_limits<double>::infinity();
+	
+	for (const auto& spike : store.query(firstNeuron, lastNeuron, start, stop)) {
+		cout << spike.step << "\t" << spike.neuron << '\n';
+	}
+	return 0;
+}
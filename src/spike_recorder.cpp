@@ -0,0 +1,147 @@
+#include "spike_recorder.hpp"
+#include <cstring>
+
+using namespace std;
+
+static_assert(sizeof(SpikeFileHeader) == 24, "the header of a spike file is 24 bytes");
+static_assert(sizeof(SpikeRecord) == 8, "a spike record is 8 bytes");
+
+static const char Magic[4] = { 'S', 'P', 'K', 'B' };
+
+//======================================================================
+//constructeurs/destructeurs
+SpikeRecorder::SpikeRecorder()
+: nbRecords_(0)
+{}
+//----------------------------------------------------------------------
+SpikeRecorder::~SpikeRecorder()
+{
+	close();
+}
+//======================================================================
+bool SpikeRecorder::open(const string& path, unsigned int nbNeurons, double dt)
+{
+	close();
+	
+	file_.open(path, ios::binary | ios::trunc);
+	if (file_.fail()) {
+		return false;
+	}
+	
+	SpikeFileHeader header;
+	memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.nbNeurons = nbNeurons;
+	header.reserved = 0;
+	header.dt = dt;
+	file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	
+	block_.reserve(BlockRecords);
+	nbRecords_ = 0;
+	return true;
+}
+//----------------------------------------------------------------------
+bool SpikeRecorder::isOpen() const
+{
+	return file_.is_open();
+}
+//----------------------------------------------------------------------
+void SpikeRecorder::record(unsigned long step, unsigned int neuron)
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	block_.push_back({ static_cast<uint32_t>(step), neuron });
+	++nbRecords_;
+	
+	if (block_.size() == BlockRecords) {
+		flush();
+	}
+}
+//----------------------------------------------------------------------
+void SpikeRecorder::record(unsigned long step, const vector<unsigned int>& neurons)
+{
+	for (auto neuron : neurons) {
+		record(step, neuron);
+	}
+}
+//----------------------------------------------------------------------
+void SpikeRecorder::record(const vector<SpikeRecord>& records)
+{
+	if (not isOpen() or records.empty()) {
+		return;
+	}
+	
+	flush();
+	file_.write(reinterpret_cast<const char*>(records.data()), records.size()*sizeof(SpikeRecord));
+	nbRecords_ += records.size();
+}
+//----------------------------------------------------------------------
+void SpikeRecorder::flush()
+{
+	if (isOpen()) {
+		file_.write(reinterpret_cast<const char*>(block_.data()), block_.size()*sizeof(SpikeRecord));
+		file_.flush();
+	}
+	block_.clear();
+}
+//----------------------------------------------------------------------
+void SpikeRecorder::close()
+{
+	flush();
+	if (isOpen()) {
+		file_.close();
+	}
+}
+//----------------------------------------------------------------------
+unsigned long SpikeRecorder::getNbRecords() const
+{
+	return nbRecords_;
+}
+//======================================================================
+//Reader
+SpikeReader::SpikeReader(const string& path)
+: file_(path, ios::binary), valid_(false)
+{
+	memset(&header_, 0, sizeof(header_));
+	
+	if (file_.read(reinterpret_cast<char*>(&header_), sizeof(header_))) {
+		valid_ = memcmp(header_.magic, Magic, sizeof(Magic)) == 0 and header_.version == SpikeRecorder::Version;
+	}
+}
+//----------------------------------------------------------------------
+bool SpikeReader::isValid() const
+{
+	return valid_;
+}
+//----------------------------------------------------------------------
+const SpikeFileHeader& SpikeReader::getHeader() const
+{
+	return header_;
+}
+//----------------------------------------------------------------------
+size_t SpikeReader::read(vector<SpikeRecord>& records, size_t maxRecords)
+{
+	records.resize(valid_ ? maxRecords : 0);
+	if (records.empty()) {
+		return 0;
+	}
+	
+	// the last block of the file may be shorter
+	file_.read(reinterpret_cast<char*>(records.data()), maxRecords*sizeof(SpikeRecord));
+	records.resize(file_.gcount()/sizeof(SpikeRecord));
+	return records.size();
+}
+//----------------------------------------------------------------------
+vector<SpikeRecord> SpikeReader::readAll()
+{
+	vector<SpikeRecord> all;
+	vector<SpikeRecord> records;
+	
+	while (read(records) > 0) {
+		all.insert(all.end(), records.begin(), records.end());
+	}
+	return all;
+}
+//======================================================================
@@ -0,0 +1,167 @@
+#ifndef spike_recorder_H
+#define spike_recorder_H
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+/**
+ * @brief Header of a binary spike file.
+ *
+ * The file is the header followed by the spikes, one SpikeRecord per spike in order of time.
+ * All the integers are stored in little-endian order (the order of x86 processors).
+ */
+struct SpikeFileHeader {
+	char magic[4]; //!< "SPKB"
+	uint32_t version; //!< Version of the format
+	uint32_t nbNeurons; //!< Number of neurons of the network
+	uint32_t reserved; //!< Zero
+	double dt; //!< Step time (ms)
+};
+
+/**
+ * @brief Record of one spike: the neuron (from 0) and the step time of the spike.
+ */
+struct SpikeRecord {
+	uint32_t step; //!< Step time of the spike
+	uint32_t neuron; //!< Index of the neuron that spiked
+};
+
+/*!
+ * @class SpikeRecorder
+ *
+ * @brief Writes the spikes of a simulation into a binary spike file.
+ *
+ * The records are kept in a block of memory and written to the file all at once when the block is full:
+ * no formatting and no flush at each spike.
+ */
+class SpikeRecorder {
+
+public:
+	static const uint32_t Version = 1; //!< Version of the format written
+
+	static const size_t BlockRecords = 1 << 16; //!< Number of records of a block (512 KiB)
+
+	/**
+	 * @brief Constructor: the recorder ignores the spikes until a file is opened.
+	 */
+	SpikeRecorder();
+
+	/**
+	 * @brief Destructor
+	 *
+	 * @note The records left in the block are written.
+	 */
+	~SpikeRecorder();
+
+	SpikeRecorder(const SpikeRecorder&) = delete;
+	SpikeRecorder& operator=(const SpikeRecorder&) = delete;
+
+	/**
+	 * @brief Open a file and write its header.
+	 *
+	 * @param path is the path of the file
+	 * @param nbNeurons is the number of neurons of the network
+	 * @param dt is the step time (ms)
+	 *
+	 * @return whether the file could be opened
+	 */
+	bool open(const std::string& path, unsigned int nbNeurons, double dt);
+
+	/**
+	 * @brief Whether a file is open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Record a spike.
+	 */
+	void record(unsigned long step, unsigned int neuron);
+
+	/**
+	 * @brief Record the spikes of a step.
+	 *
+	 * @param step is the step time of the spikes
+	 * @param neurons are the neurons that spiked
+	 */
+	void record(unsigned long step, const std::vector<unsigned int>& neurons);
+
+	/**
+	 * @brief Write a block of records directly into the file (after the records of the block not written yet).
+	 */
+	void record(const std::vector<SpikeRecord>& records);
+
+	/**
+	 * @brief Write the records of the block into the file.
+	 */
+	void flush();
+
+	/**
+	 * @brief Write the records of the block and close the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Get the number of spikes recorded since the file was opened.
+	 */
+	unsigned long getNbRecords() const;
+
+private:
+
+	std::ofstream file_; //!< Binary spike file
+
+	std::vector<SpikeRecord> block_; //!< Records not written yet
+
+	unsigned long nbRecords_; //!< Number of spikes recorded
+};
+
+/*!
+ * @class SpikeReader
+ *
+ * @brief Reads a binary spike file written by SpikeRecorder.
+ */
+class SpikeReader {
+
+public:
+	/**
+	 * @brief Constructor: opens the file and reads its header.
+	 *
+	 * @param path is the path of the file
+	 */
+	SpikeReader(const std::string& path);
+
+	/**
+	 * @brief Whether the file is open and starts with a valid header.
+	 */
+	bool isValid() const;
+
+	/**
+	 * @brief Get the header of the file.
+	 */
+	const SpikeFileHeader& getHeader() const;
+
+	/**
+	 * @brief Read the next records of the file.
+	 *
+	 * @param records receives at most maxRecords records (its content is replaced)
+	 * @param maxRecords is the maximal number of records read
+	 *
+	 * @return the number of records read (0 at the end of the file)
+	 */
+	size_t read(std::vector<SpikeRecord>& records, size_t maxRecords = SpikeRecorder::BlockRecords);
+
+	/**
+	 * @brief Read all the records left in the file.
+	 */
+	std::vector<SpikeRecord> readAll();
+
+private:
+
+	std::ifstream file_; //!< Binary spike file
+
+	SpikeFileHeader header_; //!< Header of the file
+
+	bool valid_; //!< Whether the header is valid
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "spike_selection.hpp"
+#include "constants.hpp"
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+//======================================================================
+//constructeurs/destructeurs
+SpikeSelection::SpikeSelection()
+: first_(0), last_(numeric_limits<unsigned int>::max()), every_(1),
+  startStep_(0), stopStep_(numeric_limits<unsigned long>::max())
+{}
+//======================================================================
+//setter
+void SpikeSelection::setNeurons(unsigned int first, unsigned int last, unsigned int every)
+{
+	assert(every > 0);
+	
+	first_ = first;
+	last_ = last;
+	every_ = every;
+	neurons_.clear();
+}
+//----------------------------------------------------------------------
+void SpikeSelection::setNeurons(vector<unsigned int> neurons)
+{
+	// sorted for the binary search, the spikes of a step are sorted too
+	sort(neurons.begin(), neurons.end());
+	neurons_ = neurons;
+	
+	// an empty list selects no neuron
+	first_ = 0;
+	last_ = 0;
+	every_ = 1;
+}
+//----------------------------------------------------------------------
+void SpikeSelection::setTime(double start, double stop, double timeStep)
+{
+	startStep_ = max(0L, lround(start/timeStep));
+	stopStep_ = isinf(stop) ? numeric_limits<unsigned long>::max() : max(0L, lround(stop/timeStep));
+}
+//======================================================================
+bool SpikeSelection::selectsAll() const
+{
+	return neurons_.empty() and first_ == 0 and last_ == numeric_limits<unsigned int>::max() and every_ == 1
+	       and startStep_ == 0 and stopStep_ == numeric_limits<unsigned long>::max();
+}
+//----------------------------------------------------------------------
+bool SpikeSelection::isRecorded(unsigned long step) const
+{
+	return step >= startStep_ and step < stopStep_;
+}
+//----------------------------------------------------------------------
+bool SpikeSelection::isSelected(unsigned int neuron) const
+{
+	if (not neurons_.empty()) {
+		return binary_search(neurons_.begin(), neurons_.end(), neuron);
+	}
+	return neuron >= first_ and neuron < last_ and (neuron - first_) % every_ == 0;
+}
+//----------------------------------------------------------------------
+void SpikeSelection::select(unsigned long step, const vector<unsigned int>& spikes, vector<unsigned int>& selected) const
+{
+	selected.clear();
+	
+	if (not isRecorded(step)) {
+		return;
+	}
+	
+	if (not neurons_.empty()) {
+		// both lists are sorted: one merge
+		set_intersection(spikes.begin(), spikes.end(), neurons_.begin(), neurons_.end(), back_inserter(selected));
+		return;
+	}
+	
+	// the spikes are sorted: only the spikes of the range are visited
+	auto first = lower_bound(spikes.begin(), spikes.end(), first_);
+	auto last = lower_bound(first, spikes.end(), last_);
+	for (auto spike = first; spike != last; ++spike) {
+		if ((*spike - first_) % every_ == 0) {
+			selected.push_back(*spike);
+		}
+	}
+}
+//======================================================================
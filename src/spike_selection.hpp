@@ -0,0 +1,84 @@
+#ifndef spike_selection_H
+#define spike_selection_H
+#include <vector>
+#include <limits>
+
+/*!
+ * @class SpikeSelection
+ *
+ * @brief Selection of the spikes recorded: which neurons and when.
+ *
+ * The neurons are either a range [first, last) sampled every k neurons, or a list.
+ * The spikes are only recorded during a time window [start, stop).
+ * The spikes are filtered by the network before they are handed over to the recorder:
+ * the cost of the record and the size of the files only depend on what is selected.
+ */
+class SpikeSelection {
+
+public:
+	/**
+	 * @brief Constructor: every neuron, during the whole simulation.
+	 */
+	SpikeSelection();
+
+	/**
+	 * @brief Select the neurons first, first + every, first + 2*every... of [first, last).
+	 *
+	 * @param every is the sampling of the neurons of the range. Default value = 1 (every neuron of the range)
+	 */
+	void setNeurons(unsigned int first, unsigned int last, unsigned int every = 1);
+
+	/**
+	 * @brief Select a list of neurons.
+	 */
+	void setNeurons(std::vector<unsigned int> neurons);
+
+	/**
+	 * @brief Select the time window [start, stop) (ms, rounded to the step time).
+	 *
+	 * @param start is the start of the window (ms, a negative time starts at 0)
+	 * @param stop is the end of the window (ms, a negative time records nothing, infinity for no end)
+	 * @param timeStep is the step time of the simulation (ms): the dt of the parameters of the network
+	 */
+	void setTime(double start, double stop, double timeStep);
+
+	/**
+	 * @brief Whether every spike is selected (no filter).
+	 */
+	bool selectsAll() const;
+
+	/**
+	 * @brief Whether the spikes of a step are in the time window.
+	 */
+	bool isRecorded(unsigned long step) const;
+
+	/**
+	 * @brief Whether a neuron is selected.
+	 */
+	bool isSelected(unsigned int neuron) const;
+
+	/**
+	 * @brief Select the spikes of a step.
+	 *
+	 * @param step is the step time of the spikes
+	 * @param spikes are the neurons that spiked, sorted
+	 * @param selected receives the selected neurons (its content is replaced)
+	 */
+	void select(unsigned long step, const std::vector<unsigned int>& spikes, std::vector<unsigned int>& selected) const;
+
+private:
+
+	unsigned int first_; //!< First neuron of the range
+
+	unsigned int last_; //!< Neuron following the range
+
+	unsigned int every_; //!< Sampling of the range
+
+	std::vector<unsigned int> neurons_; //!< Sorted list of the neurons, used instead of the range if not empty
+
+	unsigned long startStep_; //!< First step of the window
+
+	unsigned long stopStep_; //!< Step following the window
+};
+
+#endif
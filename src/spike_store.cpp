@@ -0,0 +1,187 @@
+#include "spike_store.hpp"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+static_assert(sizeof(SpikeStoreHeader) == 48, "the header of a spike store is 48 bytes");
+static_assert(sizeof(SpikeChunk) == 32, "an entry of the index of a spike store is 32 bytes");
+
+static const char Magic[4] = { 'S', 'P', 'K', 'S' };
+
+//======================================================================
+//Writer
+SpikeStoreWriter::SpikeStoreWriter()
+: chunkStep_(0)
+{
+	memset(&header_, 0, sizeof(header_));
+}
+//----------------------------------------------------------------------
+SpikeStoreWriter::~SpikeStoreWriter()
+{
+	close();
+}
+//----------------------------------------------------------------------
+bool SpikeStoreWriter::open(const string& path, unsigned int nbNeurons, double dt, unsigned int chunkSteps)
+{
+	close();
+	
+	file_.open(path, ios::binary | ios::trunc);
+	if (file_.fail()) {
+		return false;
+	}
+	
+	memset(&header_, 0, sizeof(header_));
+	memcpy(header_.magic, Magic, sizeof(Magic));
+	header_.version = 1;
+	header_.nbNeurons = nbNeurons;
+	header_.chunkSteps = max(1u, chunkSteps);
+	header_.dt = dt;
+	
+	// the header is complete once the store is closed: a store not closed has no index
+	file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+	
+	chunks_.clear();
+	chunk_.clear();
+	chunkStep_ = 0;
+	return true;
+}
+//----------------------------------------------------------------------
+bool SpikeStoreWriter::isOpen() const
+{
+	return file_.is_open();
+}
+//----------------------------------------------------------------------
+void SpikeStoreWriter::record(const vector<SpikeRecord>& records)
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	for (const auto& record : records) {
+		// the simulation went past the window of the current chunk
+		if (record.step >= chunkStep_ + header_.chunkSteps) {
+			writeChunk();
+			chunkStep_ = record.step - record.step % header_.chunkSteps;
+		}
+		chunk_.push_back(record);
+	}
+}
+//----------------------------------------------------------------------
+void SpikeStoreWriter::writeChunk()
+{
+	if (chunk_.empty()) {
+		return;
+	}
+	
+	// the records arrive in order of time: the sort keeps that order for each neuron
+	stable_sort(chunk_.begin(), chunk_.end(), [](const SpikeRecord& a, const SpikeRecord& b) { return a.neuron < b.neuron; });
+	
+	SpikeChunk chunk;
+	chunk.firstStep = chunkStep_;
+	chunk.offset = file_.tellp();
+	chunk.nbRecords = chunk_.size();
+	chunk.firstNeuron = chunk_.front().neuron;
+	chunk.lastNeuron = chunk_.back().neuron;
+	chunks_.push_back(chunk);
+	
+	file_.write(reinterpret_cast<const char*>(chunk_.data()), chunk_.size()*sizeof(SpikeRecord));
+	header_.nbRecords += chunk_.size();
+	chunk_.clear();
+}
+//----------------------------------------------------------------------
+void SpikeStoreWriter::close()
+{
+	if (not isOpen()) {
+		return;
+	}
+	
+	writeChunk();
+	
+	header_.nbChunks = chunks_.size();
+	header_.indexOffset = file_.tellp();
+	file_.write(reinterpret_cast<const char*>(chunks_.data()), chunks_.size()*sizeof(SpikeChunk));
+	
+	file_.seekp(0);
+	file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+	file_.close();
+}
+//======================================================================
+//Query
+SpikeStore::SpikeStore(const string& path)
+: file_(path), header_(nullptr), chunks_(nullptr)
+{
+	if (file_.size() < sizeof(SpikeStoreHeader)) {
+		return;
+	}
+	
+	const SpikeStoreHeader* header = reinterpret_cast<const SpikeStoreHeader*>(file_.data());
+	if (memcmp(header->magic, Magic, sizeof(Magic)) != 0 or header->version != 1 or header->chunkSteps == 0
+	    or header->indexOffset < sizeof(SpikeStoreHeader) or header->indexOffset > file_.size()
+	    or header->nbChunks > (file_.size() - header->indexOffset)/sizeof(SpikeChunk)) {
+		return;
+	}
+	
+	// the records of every chunk lie between the header and the index: a corrupt file is rejected
+	const SpikeChunk* chunks = reinterpret_cast<const SpikeChunk*>(file_.data() + header->indexOffset);
+	for (uint64_t c(0); c < header->nbChunks; ++c) {
+		if (chunks[c].offset < sizeof(SpikeStoreHeader) or chunks[c].offset > header->indexOffset
+		    or chunks[c].nbRecords > (header->indexOffset - chunks[c].offset)/sizeof(SpikeRecord)) {
+			return;
+		}
+	}
+	header_ = header;
+	chunks_ = chunks;
+}
+//----------------------------------------------------------------------
+bool SpikeStore::isValid() const
+{
+	return header_ != nullptr;
+}
+//----------------------------------------------------------------------
+const SpikeStoreHeader& SpikeStore::getHeader() const
+{
+	return *header_;
+}
+//----------------------------------------------------------------------
+vector<SpikeRecord> SpikeStore::query(unsigned int firstNeuron, unsigned int lastNeuron, double start, double stop) const
+{
+	vector<SpikeRecord> spikes;
+	if (not isValid() or firstNeuron >= lastNeuron or not (start < stop)) {
+		return spikes;
+	}
+	
+	uint64_t startStep = static_cast<uint64_t>(max(0L, lround(start/header_->dt)));
+	uint64_t stopStep = isinf(stop) ? UINT64_MAX : static_cast<uint64_t>(max(0L, lround(stop/header_->dt)));
+	
+	// the chunks are in order of time: the first chunk of the range is found by binary search
+	const SpikeChunk* chunk = upper_bound(chunks_, chunks_ + header_->nbChunks, startStep,
+	                                      [](uint64_t step, const SpikeChunk& c) { return step < c.firstStep; });
+	if (chunk != chunks_) {
+		--chunk;
+	}
+	
+	for (; chunk != chunks_ + header_->nbChunks and chunk->firstStep < stopStep; ++chunk) {
+		if (chunk->lastNeuron < firstNeuron or chunk->firstNeuron >= lastNeuron) {
+			continue;
+		}
+		
+		// the records of the chunk are sorted by neuron
+		const SpikeRecord* records = reinterpret_cast<const SpikeRecord*>(file_.data() + chunk->offset);
+		const SpikeRecord* first = lower_bound(records, records + chunk->nbRecords, firstNeuron,
+		                                       [](const SpikeRecord& r, unsigned int neuron) { return r.neuron < neuron; });
+		
+		for (const SpikeRecord* record = first; record != records + chunk->nbRecords and record->neuron < lastNeuron; ++record) {
+			if (record->step >= startStep and record->step < stopStep) {
+				spikes.push_back(*record);
+			}
+		}
+	}
+	
+	sort(spikes.begin(), spikes.end(), [](const SpikeRecord& a, const SpikeRecord& b) {
+		return a.step < b.step or (a.step == b.step and a.neuron < b.neuron);
+	});
+	return spikes;
+}
+//======================================================================
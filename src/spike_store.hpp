@@ -0,0 +1,157 @@
+#ifndef spike_store_H
+#define spike_store_H
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "spike_recorder.hpp"
+#include "mapped_file.hpp"
+
+/**
+ * @brief Header of a spike store file.
+ *
+ * The file is the header, then the chunks of records, then the index of the chunks (nbChunks SpikeChunk).
+ * A chunk holds the spikes of a window of chunkSteps steps, sorted by neuron then by step.
+ * All the integers are stored in little-endian order.
+ */
+struct SpikeStoreHeader {
+	char magic[4]; //!< "SPKS"
+	uint32_t version; //!< Version of the format
+	uint32_t nbNeurons; //!< Number of neurons of the network
+	uint32_t chunkSteps; //!< Number of steps of the window of a chunk
+	double dt; //!< Step time (ms)
+	uint64_t nbChunks; //!< Number of chunks (the windows without spikes have no chunk)
+	uint64_t indexOffset; //!< Position of the index of the chunks in the file (bytes)
+	uint64_t nbRecords; //!< Number of spikes of the file
+};
+
+/**
+ * @brief Entry of the index of a spike store: position and content of a chunk.
+ */
+struct SpikeChunk {
+	uint64_t firstStep; //!< First step of the window of the chunk (multiple of chunkSteps)
+	uint64_t offset; //!< Position of the first record of the chunk in the file (bytes)
+	uint64_t nbRecords; //!< Number of records of the chunk
+	uint32_t firstNeuron; //!< Smallest neuron of the chunk
+	uint32_t lastNeuron; //!< Largest neuron of the chunk
+};
+
+/*!
+ * @class SpikeStoreWriter
+ *
+ * @brief Writes the spikes of a simulation into a spike store, indexed by time and by neuron.
+ *
+ * The spikes of the current window are kept in memory and written as one chunk, sorted by neuron,
+ * once the simulation goes past the window. The index is written when the store is closed.
+ */
+class SpikeStoreWriter {
+
+public:
+	/**
+	 * @brief Constructor: the writer ignores the spikes until a file is opened.
+	 */
+	SpikeStoreWriter();
+
+	/**
+	 * @brief Destructor
+	 *
+	 * @note The store is closed (see close).
+	 */
+	~SpikeStoreWriter();
+
+	SpikeStoreWriter(const SpikeStoreWriter&) = delete;
+	SpikeStoreWriter& operator=(const SpikeStoreWriter&) = delete;
+
+	/**
+	 * @brief Open a file.
+	 *
+	 * @param path is the path of the file
+	 * @param nbNeurons is the number of neurons of the network
+	 * @param dt is the step time (ms)
+	 * @param chunkSteps is the number of steps of the window of a chunk
+	 *
+	 * @return whether the file could be opened
+	 */
+	bool open(const std::string& path, unsigned int nbNeurons, double dt, unsigned int chunkSteps);
+
+	/**
+	 * @brief Whether a file is open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Record spikes, in order of time.
+	 */
+	void record(const std::vector<SpikeRecord>& records);
+
+	/**
+	 * @brief Write the last chunk and the index, then close the file.
+	 */
+	void close();
+
+private:
+
+	/**
+	 * @brief Write the spikes of the current window as a chunk.
+	 */
+	void writeChunk();
+
+	std::ofstream file_; //!< Spike store file
+
+	SpikeStoreHeader header_; //!< Header, written again when the store is closed
+
+	std::vector<SpikeChunk> chunks_; //!< Index of the chunks written
+
+	unsigned long chunkStep_; //!< First step of the current window
+
+	std::vector<SpikeRecord> chunk_; //!< Spikes of the current window
+};
+
+/*!
+ * @class SpikeStore
+ *
+ * @brief Query of the spikes of a spike store, mapped in memory.
+ *
+ * A query only reads the chunks of its time range, and inside each chunk
+ * the records of its neuron range are found by binary search (the records are sorted by neuron).
+ */
+class SpikeStore {
+
+public:
+	/**
+	 * @brief Constructor: maps the file in memory.
+	 *
+	 * @param path is the path of the file
+	 */
+	SpikeStore(const std::string& path);
+
+	/**
+	 * @brief Whether the file is mapped and is a complete spike store, whose chunks all lie inside the file.
+	 */
+	bool isValid() const;
+
+	/**
+	 * @brief Get the header of the store.
+	 */
+	const SpikeStoreHeader& getHeader() const;
+
+	/**
+	 * @brief Get the spikes of the neurons of [firstNeuron, lastNeuron) during [start, stop).
+	 *
+	 * @param start is the start time (ms)
+	 * @param stop is the end time (ms)
+	 *
+	 * @return the spikes, in order of time then of neuron
+	 */
+	std::vector<SpikeRecord> query(unsigned int firstNeuron, unsigned int lastNeuron, double start, double stop) const;
+
+private:
+
+	MappedFile file_; //!< Store file
+
+	const SpikeStoreHeader* header_; //!< Header of the store, inside the file
+
+	const SpikeChunk* chunks_; //!< Index of the chunks, inside the file
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef spsc_ring_H
+#define spsc_ring_H
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+/*!
+ * @class SpscRing
+ *
+ * @brief Lock-free ring of fixed capacity between one producer thread and one consumer thread.
+ *
+ * The producer only writes the tail and the consumer only writes the head: an element is handed over
+ * by a release store of the index, read by the other thread with an acquire load. No lock is taken.
+ *
+ * @note push must only be called by the producer thread and pop by the consumer thread.
+ */
+template <typename T>
+class SpscRing {
+
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param capacity is the maximal number of elements in the ring
+	 */
+	explicit SpscRing(size_t capacity)
+	: slots_(capacity + 1), head_(0), tail_(0)
+	{}
+
+	/**
+	 * @brief Get the maximal number of elements in the ring.
+	 */
+	size_t capacity() const
+	{
+		return slots_.size() - 1;
+	}
+
+	/**
+	 * @brief Whether the ring is empty.
+	 */
+	bool empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Add an element at the tail of the ring (producer).
+	 *
+	 * @return false if the ring is full (the element is not added)
+	 */
+	bool push(const T& value)
+	{
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		size_t next = (tail + 1) % slots_.size();
+
+		if (next == head_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		slots_[tail] = value;
+		tail_.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Remove the element at the head of the ring (consumer).
+	 *
+	 * @return false if the ring is empty
+	 */
+	bool pop(T& value)
+	{
+		size_t head = head_.load(std::memory_order_relaxed);
+
+		if (head == tail_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = slots_[head];
+		head_.store((head + 1) % slots_.size(), std::memory_order_release);
+		return true;
+	}
+
+private:
+
+	std::vector<T> slots_; //!< Elements, one slot always empty to tell a full ring from an empty one
+
+	std::atomic<size_t> head_; //!< Next element to pop, written by the consumer
+
+	char padding_[64]; //!< Keeps the head and the tail on different cache lines
+
+	std::atomic<size_t> tail_; //!< Next slot to push, written by the producer
+};
+
+#endif
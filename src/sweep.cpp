@@ -0,0 +1,373 @@
+#include "sweep.hpp"
+#include "network.hpp"
+#include "thread_pool.hpp"
+#include <iostream>
+#include <fstream>
+#include <cerrno>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <iomanip>
+#include <cassert>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+//======================================================================
+vector<SweepPoint> readSweepPoints(istream& in)
+{
+	vector<SweepPoint> points;
+	SweepPoint point;
+	
+	while (in >> point.g >> point.eta >> point.seed) {
+		points.push_back(point);
+	}
+	return points;
+}
+//----------------------------------------------------------------------
+string getPointDirectory(const string& directory, unsigned int point)
+{
+	ostringstream name;
+	name << directory << "/point" << point;
+	return name.str();
+}
+//======================================================================
+//Simulation of one point, in the forked process
+static int runPoint(Network& network, const SweepPoint& point, const string& directory, unsigned int nbThreads)
+{
+	if (mkdir(directory.c_str(), 0755) != 0 and errno != EEXIST) {
+		cerr << "Error creating directory " << directory << endl;
+		return 1;
+	}
+	if (not network.setOutputDirectory(directory)) {
+		cerr << "Error opening file " << endl;
+		return 1;
+	}
+	
+	network.setNbThreads(nbThreads);
+	network.setG(point.g);
+	network.setEta(point.eta);
+	network.setExternalSeed(point.seed);
+	
+	network.update();
+	
+	// the records are written before the process ends
+	network.setOutputDirectory("");
+	return 0;
+}
+//----------------------------------------------------------------------
+//Wait for the end of one simulation, returns whether it succeeded
+static bool waitPoint()
+{
+	int status;
+	if (wait(&status) < 0) {
+		return false;
+	}
+	return WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+//======================================================================
+unsigned int runForkedSweep(Network& network, const vector<SweepPoint>& points, const string& directory,
+                            unsigned int nbProcesses, unsigned int nbThreads)
+{
+	// no thread may run while forking: only the calling thread is copied in the new process
+	network.setOutputDirectory("");
+	network.setNbThreads(1);
+	network.setCheckpoint("", 0.0);
+	cout.flush();
+	cerr.flush();
+	
+	unsigned int nbRunning(0);
+	unsigned int nbFailed(0);
+	
+	for (unsigned int k(0); k < points.size(); ++k) {
+		if (nbRunning == nbProcesses) {
+			nbFailed += not waitPoint();
+			--nbRunning;
+		}
+		
+		pid_t pid = fork();
+		if (pid == 0) {
+			// _exit: the process must not run the destructors and the exit functions of the calling process
+			_exit(runPoint(network, points[k], getPointDirectory(directory, k), nbThreads));
+		}
+		
+		if (pid < 0) {
+			cerr << "Error forking point " << k << endl;
+			++nbFailed;
+		} else {
+			++nbRunning;
+		}
+	}
+	
+	for (; nbRunning > 0; --nbRunning) {
+		nbFailed += not waitPoint();
+	}
+	return nbFailed;
+}
+//======================================================================
+//Grid of the points
+bool SweepGrid::set(const string& axis)
+{
+	size_t equal = axis.find('=');
+	if (equal == string::npos) {
+		return false;
+	}
+	string name = axis.substr(0, equal);
+	string values = axis.substr(equal + 1);
+	
+	// first:last:step, or a list of values separated by commas
+	vector<double> numbers;
+	char* end;
+	double first = strtod(values.c_str(), &end);
+	if (end == values.c_str()) {
+		return false;
+	}
+	if (*end == ':') {
+		double last = strtod(end + 1, &end);
+		double step = (*end == ':') ? strtod(end + 1, &end) : 0.0;
+		if (*end != '\0' or not (step > 0.0) or last < first) {
+			return false;
+		}
+		// the last value is included despite the rounding of the steps
+		unsigned long nbValues = static_cast<unsigned long>(floor((last - first)/step + 1e-9)) + 1;
+		for (unsigned long k(0); k < nbValues; ++k) {
+			numbers.push_back(first + k*step);
+		}
+	} else {
+		numbers.push_back(first);
+		while (*end == ',') {
+			const char* next = end + 1;
+			numbers.push_back(strtod(next, &end));
+			if (end == next) {
+				return false;
+			}
+		}
+		if (*end != '\0') {
+			return false;
+		}
+	}
+	
+	if (name == "g") {
+		g_ = numbers;
+	} else if (name == "Eta") {
+		eta_ = numbers;
+	} else if (name == "seed") {
+		// the seeds are converted exactly: integers of a double
+		for (double seed : numbers) {
+			if (not (seed >= 0.0 and seed <= 9007199254740992.0) or seed != floor(seed)) {
+				return false;
+			}
+		}
+		seeds_.assign(numbers.begin(), numbers.end());
+	} else {
+		return false;
+	}
+	return true;
+}
+//----------------------------------------------------------------------
+vector<SweepPoint> SweepGrid::getPoints(const Parameters& parameters, uint64_t seed) const
+{
+	vector<double> g = g_.empty() ? vector<double>(1, parameters.g) : g_;
+	vector<double> eta = eta_.empty() ? vector<double>(1, parameters.eta) : eta_;
+	vector<uint64_t> seeds = seeds_.empty() ? vector<uint64_t>(1, seed) : seeds_;
+	
+	vector<SweepPoint> points;
+	for (auto relativeStrength : g) {
+		for (auto frequency : eta) {
+			for (auto pointSeed : seeds) {
+				points.push_back({ relativeStrength, frequency, pointSeed });
+			}
+		}
+	}
+	return points;
+}
+//======================================================================
+//Summaries
+static const char* SummaryColumns = "point,g,eta,seed,excitatory,inhibitory,cv,seconds";
+//----------------------------------------------------------------------
+static void writeSummary(ostream& out, const SweepSummary& summary)
+{
+	// g and Eta with all their digits: the points are recognized when the sweep is resumed
+	out << summary.point << ',' << setprecision(17) << summary.parameters.g << ',' << summary.parameters.eta << ','
+	    << summary.parameters.seed << ',' << setprecision(6) << summary.excitatoryRate << ',' << summary.inhibitoryRate << ','
+	    << summary.activityCV << ',' << summary.seconds << '\n';
+}
+//----------------------------------------------------------------------
+vector<SweepSummary> readSweepSummaries(const string& path)
+{
+	vector<SweepSummary> summaries;
+	ifstream file(path);
+	string line;
+	
+	if (not getline(file, line) or line != SummaryColumns) {
+		return summaries;
+	}
+	
+	// the last line of an interrupted sweep may be incomplete
+	while (getline(file, line) and not file.eof()) {
+		SweepSummary summary;
+		char comma[7];
+		istringstream in(line);
+		if (in >> summary.point >> comma[0] >> summary.parameters.g >> comma[1] >> summary.parameters.eta >> comma[2]
+		       >> summary.parameters.seed >> comma[3] >> summary.excitatoryRate >> comma[4] >> summary.inhibitoryRate
+		       >> comma[5] >> summary.activityCV >> comma[6] >> summary.seconds) {
+			summaries.push_back(summary);
+		}
+	}
+	return summaries;
+}
+//======================================================================
+//Scheduler
+SweepScheduler::SweepScheduler(double networkStopTime, unsigned int nbNeurons, Connectivity connectivity, const Parameters& parameters)
+: networkStopTime_(networkStopTime), nbNeurons_(nbNeurons), connectivity_(connectivity), parameters_(parameters),
+  nbThreads_(max(1u, thread::hardware_concurrency())), memoryLimit_(0), transient_(0.0)
+{}
+//----------------------------------------------------------------------
+void SweepScheduler::setNbThreads(unsigned int nbThreads)
+{
+	assert(nbThreads > 0);
+	nbThreads_ = nbThreads;
+}
+//----------------------------------------------------------------------
+void SweepScheduler::setMemoryLimit(size_t memoryLimit)
+{
+	memoryLimit_ = memoryLimit;
+}
+//----------------------------------------------------------------------
+void SweepScheduler::setTransient(double transient)
+{
+	transient_ = transient;
+}
+//----------------------------------------------------------------------
+size_t SweepScheduler::getNetworkMemory() const
+{
+	// one thread per network, with the rates of simulate
+	return Network::planMemory(nbNeurons_, connectivity_, parameters_, 1, networkStopTime_, RateBinWidth).getPeak();
+}
+//----------------------------------------------------------------------
+unsigned int SweepScheduler::getNbConcurrent() const
+{
+	if (memoryLimit_ == 0) {
+		return nbThreads_;
+	}
+	size_t nbNetworks = max<size_t>(1, memoryLimit_/max<size_t>(1, getNetworkMemory()));
+	return static_cast<unsigned int>(min<size_t>(nbThreads_, nbNetworks));
+}
+//----------------------------------------------------------------------
+SweepSummary SweepScheduler::simulate(unsigned int point, const SweepPoint& parameters) const
+{
+	auto start = chrono::steady_clock::now();
+	
+	Parameters model(parameters_);
+	model.g = parameters.g;
+	model.eta = parameters.eta;
+	
+	// one thread and no file: the spikes are only counted, in bins of 1 ms after the transient
+	Network network(networkStopTime_, nbNeurons_, connectivity_, model, parameters.seed, "");
+	network.setRates(RateRecorder(RateBinWidth, transient_, numeric_limits<double>::infinity(), model.dt));
+	network.update();
+	
+	const RateRecorder& rates = network.getRates();
+	unsigned long nbExcitatorySpikes(0), nbInhibitorySpikes(0);
+	double sum(0.0), sumOfSquares(0.0);
+	for (size_t bin(0); bin < rates.getNbBins(); ++bin) {
+		nbExcitatorySpikes += rates.getNbExcitatorySpikes(bin);
+		nbInhibitorySpikes += rates.getNbInhibitorySpikes(bin);
+		
+		double activity = rates.getNbExcitatorySpikes(bin) + rates.getNbInhibitorySpikes(bin);
+		sum += activity;
+		sumOfSquares += activity*activity;
+	}
+	
+	unsigned int nbInhibitory(0);
+	for (unsigned int i(0); i < nbNeurons_; ++i) {
+		nbInhibitory += network.getPopulation().isInhibiter(i);
+	}
+	unsigned int nbExcitatory = nbNeurons_ - nbInhibitory;
+	
+	// rates in Hz: spikes per neuron per second
+	double duration = rates.getNbBins()*rates.getBinWidth()/1000.0;
+	double mean = rates.getNbBins() > 0 ? sum/rates.getNbBins() : 0.0;
+	double variance = rates.getNbBins() > 0 ? max(0.0, sumOfSquares/rates.getNbBins() - mean*mean) : 0.0;
+	
+	SweepSummary summary;
+	summary.point = point;
+	summary.parameters = parameters;
+	summary.excitatoryRate = (nbExcitatory > 0 and duration > 0.0) ? nbExcitatorySpikes/(nbExcitatory*duration) : 0.0;
+	summary.inhibitoryRate = (nbInhibitory > 0 and duration > 0.0) ? nbInhibitorySpikes/(nbInhibitory*duration) : 0.0;
+	summary.activityCV = mean > 0.0 ? sqrt(variance)/mean : 0.0;
+	summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return summary;
+}
+//----------------------------------------------------------------------
+bool SweepScheduler::run(const vector<SweepPoint>& points, const string& summaryPath, unsigned int& nbSimulated) const
+{
+	nbSimulated = 0;
+	
+	// the points of the file with the same parameters are done
+	vector<SweepSummary> summaries = readSweepSummaries(summaryPath);
+	vector<bool> isDone(points.size(), false);
+	vector<SweepSummary> kept;
+	for (const auto& summary : summaries) {
+		if (summary.point < points.size() and not isDone[summary.point]
+		    and summary.parameters.g == points[summary.point].g and summary.parameters.eta == points[summary.point].eta
+		    and summary.parameters.seed == points[summary.point].seed) {
+			isDone[summary.point] = true;
+			kept.push_back(summary);
+		}
+	}
+	
+	// the file is written again without the incomplete line and the points of another sweep
+	{
+		ofstream file(summaryPath + ".tmp", ios::trunc);
+		file << SummaryColumns << '\n';
+		for (const auto& summary : kept) {
+			writeSummary(file, summary);
+		}
+		if (not file.flush() or rename((summaryPath + ".tmp").c_str(), summaryPath.c_str()) != 0) {
+			cerr << "Error opening file " << summaryPath << endl;
+			return false;
+		}
+	}
+	
+	vector<unsigned int> todo;
+	for (unsigned int k(0); k < points.size(); ++k) {
+		if (not isDone[k]) {
+			todo.push_back(k);
+		}
+	}
+	
+	ofstream file(summaryPath, ios::app);
+	if (not file) {
+		cerr << "Error opening file " << summaryPath << endl;
+		return false;
+	}
+	mutex fileMutex;
+	atomic<size_t> next(0);
+	
+	// each thread takes the next point as soon as it has finished one: the points may last very differently
+	ThreadPool threads(min<size_t>(getNbConcurrent(), max<size_t>(1, todo.size())));
+	threads.run([&](unsigned int) {
+		for (size_t k = next++; k < todo.size(); k = next++) {
+			SweepSummary summary = simulate(todo[k], points[todo[k]]);
+			
+			// a whole line per point, written at once: an interrupted sweep loses at most the points being simulated
+			lock_guard<mutex> lock(fileMutex);
+			writeSummary(file, summary);
+			file.flush();
+		}
+	});
+	nbSimulated = todo.size();
+	return bool(file);
+}
+//======================================================================
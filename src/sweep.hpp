@@ -0,0 +1,197 @@
+#ifndef sweep_H
+#define sweep_H
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iosfwd>
+#include "network.hpp"
+
+/**
+ * @brief Parameters of one simulation of a sweep.
+ */
+struct SweepPoint {
+	double g; //!< Relative strength of the inhibitory synapses
+	double eta; //!< External frequency relative to the threshold frequency
+	uint64_t seed; //!< Seed of the external spikes for a forked sweep, of the whole network for a scheduled sweep
+};
+
+/**
+ * @brief Read the points of a sweep, one line "g eta seed" per point.
+ *
+ * @return the points read until the end of the stream (or the first line which is not a point)
+ */
+std::vector<SweepPoint> readSweepPoints(std::istream& in);
+
+/**
+ * @brief Run one simulation per point, each in a process forked from the network.
+ *
+ * The network is typically restored from an equilibrated snapshot: every simulation starts from its state
+ * (potentials, delay ring, clock) instead of simulating the transient again.
+ * The processes share the memory of the network copy-on-write: the connections are never written,
+ * so they stay in memory only once whatever the number of processes.
+ *
+ * The simulation of point k writes its files (spikes.bin, spikes2.txt, rates.csv) in directory/pointk
+ * and runs until the stop time of the network.
+ * The network of the calling process is not simulated: it is left without file and with one thread,
+ * since a process must not be forked while other threads are running.
+ *
+ * @param network is the network at the start of the simulations
+ * @param points are the parameters of the simulations
+ * @param directory is the directory of the files of the simulations (it must exist)
+ * @param nbProcesses is the maximal number of simulations running at the same time
+ * @param nbThreads is the number of threads of each simulation. Default value = 1
+ *
+ * @return the number of simulations which failed
+ */
+unsigned int runForkedSweep(Network& network, const std::vector<SweepPoint>& points, const std::string& directory,
+                            unsigned int nbProcesses, unsigned int nbThreads = 1);
+
+/**
+ * @brief Get the directory of the files of a point of a sweep.
+ */
+std::string getPointDirectory(const std::string& directory, unsigned int point);
+
+/*!
+ * @class SweepGrid
+ *
+ * @brief Grid of the points of a sweep: every combination of the values of g, Eta and the seed.
+ *
+ * The values of an axis are given as "name=first:last:step" (last included), "name=v1,v2,v3" or "name=v",
+ * where name is g, Eta or seed. An axis without values takes the value of the parameters of the sweep.
+ * The seeds are integers from 0 to 2^53 (exact in a double).
+ */
+class SweepGrid {
+
+public:
+	/**
+	 * @brief Set the values of an axis.
+	 *
+	 * @return whether the axis is valid (a negative, fractional or too large seed is not)
+	 */
+	bool set(const std::string& axis);
+
+	/**
+	 * @brief Get the points of the grid, g varying the slowest and the seed the fastest.
+	 *
+	 * @param parameters give g and Eta when their axes have no values
+	 * @param seed is the seed when its axis has no values
+	 */
+	std::vector<SweepPoint> getPoints(const Parameters& parameters, uint64_t seed = Network::DefaultSeed) const;
+
+private:
+
+	std::vector<double> g_; //!< Values of g
+
+	std::vector<double> eta_; //!< Values of Eta
+
+	std::vector<uint64_t> seeds_; //!< Values of the seed
+};
+
+/**
+ * @brief Summary statistics of the simulation of a point, after the transient.
+ */
+struct SweepSummary {
+	unsigned int point; //!< Index of the point in the sweep
+	SweepPoint parameters; //!< Parameters of the point
+	double excitatoryRate; //!< Mean rate of the excitatory neurons (Hz)
+	double inhibitoryRate; //!< Mean rate of the inhibitory neurons (Hz)
+	double activityCV; //!< Coefficient of variation of the activity of the population (0 for an asynchronous irregular state)
+	double seconds; //!< Wall-clock time of the simulation (s)
+};
+
+/**
+ * @brief Read the summaries of a summary file (see SweepScheduler::run).
+ *
+ * @return the summaries of the complete lines of the file (none if the file does not exist)
+ */
+std::vector<SweepSummary> readSweepSummaries(const std::string& path);
+
+/*!
+ * @class SweepScheduler
+ *
+ * @brief Runs the points of a sweep as independent networks on the threads of the machine.
+ *
+ * Each thread simulates one network at a time, with one thread and without file, then takes the next point:
+ * the points are independent, so the sweep goes as fast as the cores allow whatever the size of the networks.
+ * The number of networks simulated at the same time is limited by the memory they need (see setMemoryLimit).
+ *
+ * The summary of each point is appended to a CSV file as soon as the point is simulated.
+ * A sweep that was interrupted is resumed by running it again: the points of the file are not simulated again.
+ */
+class SweepScheduler {
+
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param networkStopTime is the end time of the simulation of each point
+	 * @param nbNeurons is the number of neurons of each network
+	 * @param connectivity is the storage of the connections. Default value = stored
+	 * @param parameters are the parameters of the networks (g and Eta are set by the points)
+	 */
+	SweepScheduler(double networkStopTime, unsigned int nbNeurons, Connectivity connectivity = Connectivity::Stored,
+	               const Parameters& parameters = Parameters());
+
+	/**
+	 * @brief Set the number of threads simulating the points. Default value = number of cores of the machine
+	 */
+	void setNbThreads(unsigned int nbThreads);
+
+	/**
+	 * @brief Set the memory the networks simulated at the same time may use (bytes, 0 for no limit). Default value = 0
+	 *
+	 * @note At least one network is simulated, even if it needs more memory.
+	 */
+	void setMemoryLimit(size_t memoryLimit);
+
+	/**
+	 * @brief Set the time before which the spikes are not in the summaries (ms). Default value = 0
+	 */
+	void setTransient(double transient);
+
+	/**
+	 * @brief Get the number of networks simulated at the same time: the threads, within the memory limit.
+	 */
+	unsigned int getNbConcurrent() const;
+
+	/**
+	 * @brief Estimate the peak of the memory needed by one network (bytes), planned for the duration of the simulations.
+	 */
+	size_t getNetworkMemory() const;
+
+	/**
+	 * @brief Simulate one point.
+	 */
+	SweepSummary simulate(unsigned int point, const SweepPoint& parameters) const;
+
+	/**
+	 * @brief Simulate the points which are not in the summary file yet and append their summaries to the file.
+	 *
+	 * @param points are the points of the sweep (the summary of point k has the index k)
+	 * @param summaryPath is the CSV file of the summaries, one line per point in the order they are simulated
+	 * @param nbSimulated receives the number of points simulated (the others were already in the file)
+	 *
+	 * @return whether the summaries could be written (no point is simulated if the file cannot be rewritten)
+	 */
+	bool run(const std::vector<SweepPoint>& points, const std::string& summaryPath, unsigned int& nbSimulated) const;
+
+private:
+
+	static constexpr double RateBinWidth = 1.0; //!< Width of the bins of the rates of the points [ms]
+
+	double networkStopTime_; //!< End time of the simulations
+
+	unsigned int nbNeurons_; //!< Number of neurons of the networks
+
+	Connectivity connectivity_; //!< Storage of the connections
+
+	Parameters parameters_; //!< Parameters of the networks
+
+	unsigned int nbThreads_; //!< Number of threads simulating the points
+
+	size_t memoryLimit_; //!< Memory of the networks simulated at the same time (0 for no limit)
+
+	double transient_; //!< Start time of the statistics
+};
+
+#endif
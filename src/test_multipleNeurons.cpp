@@ -1,14 +1,25 @@
 #include "network.hpp"
 #include "neuron.hpp"
+#include "parameters.hpp"
 #include <iostream>
+#include <cstdlib>
+#include <string>
 
 using namespace std;
 
-int main()
+int main(int argc, char** argv)
 {
 	double stopTime;
 	unsigned int NbNeurons;
 
+	// Parameters of the model: "name=value" or "config=file" anywhere on the command line (see parameters.hpp)
+	// The other arguments are the positional ones below
+	Parameters parameters;
+	vector<string> arguments;
+	if (not parameters.parse(argc, argv, arguments) or not parameters.isValid()) {
+		cerr << "Invalid parameters" << endl;
+		return 1;
+	}
 	
 	cout << "Entrez le nombre de neurones: "; 
 	cin >> NbNeurons;
@@ -18,16 +29,60 @@ int main()
 	cin >> stopTime;
 	assert(stopTime>0);
 	
-	vector<Neuron*> neurons;
+	// Optional second argument: procedural connections (drawn again at each spike instead of being stored)
+	Connectivity connectivity = Connectivity::Stored;
+	if (arguments.size() > 1 && arguments[1] == "procedural") {
+		connectivity = Connectivity::Procedural;
+	}
+	
+	// Optional third argument: seed of the random numbers
+	uint64_t seed = Network::DefaultSeed;
+	if (arguments.size() > 2) {
+		seed = strtoull(arguments[2].c_str(), nullptr, 10);
+	}
+	
+	// The neurons are stored in the population of the network
+	Network network(stopTime, NbNeurons, connectivity, parameters, seed);
+	
+	// The spikes are also stored indexed by time and neuron, for the range queries of spike_query,
+	// and compressed in an archive
+	if (not network.openSpikeStore() or not network.openSpikeArchive()) {
+		cerr << "Error opening file " << endl;
+	}
 	
-	for (unsigned int i(0); i < NbNeurons; ++i) {
-		Neuron* n = new Neuron(1);
-		neurons.push_back(n);
+	// Optional first argument: number of threads updating the neurons
+	if (arguments.size() > 0) {
+		int nbThreads = atoi(arguments[0].c_str());
+		assert(nbThreads > 0);
+		network.setNbThreads(nbThreads);
 	}
 
-	Network network(stopTime, neurons);
+	// Optional fourth argument: snapshot of the simulation, saved every 100 ms
+	// If the snapshot exists, the simulation continues from it (a stopped run is resumed by the same command)
+	if (arguments.size() > 3) {
+		if (network.restore(arguments[3])) {
+			cout << "Simulation restored at " << network.getClock()*parameters.dt << " ms" << endl;
+		}
+		network.setCheckpoint(arguments[3], 100.0);
+	}
 
+	// Performance counters of each phase, when the processor and the kernel give them
+	if (Profiler::Enabled and not network.getProfiler().setCounters(true)) {
+		cerr << "Performance counters unavailable (see /proc/sys/kernel/perf_event_paranoid): the phases are only timed" << endl;
+	}
+	
 	network.update();		
+	
+	// Time spent in each phase, when compiled with NEURON_PROFILE: summary, and trace for chrome://tracing
+	if (Profiler::Enabled) {
+		network.getProfiler().writeSummary(cout);
+		if (not network.getProfiler().writeTrace(network.getOutputDirectory() + "/trace.json")) {
+			cerr << "Error opening file " << endl;
+		}
+	}
+	
+	// Memory held by each structure of the network, slack of the vectors included
+	network.getMemoryReport().write(cout);
 			
 	return 0;
 }
@@ -0,0 +1,83 @@
+#include "thread_pool.hpp"
+
+using namespace std;
+
+//======================================================================
+//constructeurs/destructeurs
+ThreadPool::ThreadPool(unsigned int nbThreads)
+: job_(nullptr), generation_(0), pending_(0), stop_(false)
+{
+	for (unsigned int t(1); t < nbThreads; ++t) {
+		workers_.push_back(thread(&ThreadPool::work, this, t));
+	}
+}
+//----------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(mutex_);
+		stop_ = true;
+	}
+	start_.notify_all();
+	
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+//======================================================================
+unsigned int ThreadPool::size() const
+{
+	return workers_.size() + 1;
+}
+//======================================================================
+//run a job on every thread
+void ThreadPool::run(const function<void(unsigned int)>& job)
+{
+	if (workers_.empty()) {
+		job(0);
+		return;
+	}
+	
+	{
+		lock_guard<mutex> lock(mutex_);
+		job_ = &job;
+		pending_ = workers_.size();
+		++generation_;
+	}
+	start_.notify_all();
+	
+	// the calling thread is thread 0
+	job(0);
+	
+	// barrier: wait for the other threads
+	unique_lock<mutex> lock(mutex_);
+	done_.wait(lock, [this]() { return pending_ == 0; });
+	job_ = nullptr;
+}
+//----------------------------------------------------------------------
+void ThreadPool::work(unsigned int id)
+{
+	unsigned long generation(0);
+	
+	while (true) {
+		const function<void(unsigned int)>* job;
+		{
+			unique_lock<mutex> lock(mutex_);
+			start_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+			if (stop_) {
+				return;
+			}
+			generation = generation_;
+			job = job_;
+		}
+		
+		(*job)(id);
+		
+		{
+			lock_guard<mutex> lock(mutex_);
+			--pending_;
+		}
+		done_.notify_one();
+	}
+}
+//======================================================================
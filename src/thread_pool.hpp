@@ -0,0 +1,76 @@
+#ifndef thread_pool_H
+#define thread_pool_H
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/*!
+ * @class ThreadPool
+ *
+ * @brief Fixed set of threads running the same job in parallel.
+ *
+ * The threads are created once and wait between two jobs, so that a job can be run at each steptime
+ * of the simulation without creating threads. The calling thread takes part in the job as thread 0.
+ */
+class ThreadPool {
+
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param nbThreads is the number of threads running a job (calling thread included). Default value = 1
+	 */
+	ThreadPool(unsigned int nbThreads = 1);
+
+	/**
+	 * @brief Destructor
+	 *
+	 * @note Waits for the threads to finish.
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Get the number of threads running a job.
+	 */
+	unsigned int size() const;
+
+	/**
+	 * @brief Run a job on all the threads.
+	 *
+	 * Each thread calls job(t) with its number t in [0, size()).
+	 * The function returns once all the threads have finished: it acts as a barrier.
+	 *
+	 * @param job is the function run by each thread
+	 */
+	void run(const std::function<void(unsigned int)>& job);
+
+private:
+
+	/**
+	 * @brief Main loop of the thread number id: wait for a job, run it, signal its end.
+	 */
+	void work(unsigned int id);
+
+	std::vector<std::thread> workers_; //!< Threads 1 to size()-1
+
+	std::mutex mutex_; //!< Protects the fields below
+
+	std::condition_variable start_; //!< Signals a new job (or the end) to the threads
+
+	std::condition_variable done_; //!< Signals the end of the job to the calling thread
+
+	const std::function<void(unsigned int)>* job_; //!< Current job
+
+	unsigned long generation_; //!< Number of jobs started
+
+	unsigned int pending_; //!< Number of threads still running the current job
+
+	bool stop_; //!< Whether the threads must end
+};
+
+#endif